@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins_inet/VeinsInetAggregationHeaderSerializer.h"
+
+#include "inet/common/packet/serializer/ChunkSerializerRegistry.h"
+
+#include "veins_inet/VeinsInetAggregationHeader_m.h"
+
+using namespace inet;
+using veins::VeinsInetAggregationHeaderSerializer;
+
+Register_Serializer(VeinsInetAggregationHeader, VeinsInetAggregationHeaderSerializer);
+
+void VeinsInetAggregationHeaderSerializer::serialize(MemoryOutputStream& stream, const Ptr<const Chunk>& chunk) const
+{
+    b start = stream.getLength();
+    const auto& header = staticPtrCast<const VeinsInetAggregationHeader>(chunk);
+    stream.writeUint16Be(header->getReportLengthsArraySize());
+    for (size_t i = 0; i < header->getReportLengthsArraySize(); i++) {
+        stream.writeUint16Be(header->getReportLengths(i));
+    }
+    ASSERT(stream.getLength() - start == header->getChunkLength());
+}
+
+const Ptr<Chunk> VeinsInetAggregationHeaderSerializer::deserialize(MemoryInputStream& stream) const
+{
+    auto header = makeShared<VeinsInetAggregationHeader>();
+    size_t count = stream.readUint16Be();
+    header->setReportLengthsArraySize(count);
+    for (size_t i = 0; i < count; i++) {
+        header->setReportLengths(i, stream.readUint16Be());
+    }
+    header->setChunkLength(B(2 + 2 * count));
+    return header;
+}
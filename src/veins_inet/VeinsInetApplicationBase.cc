@@ -35,6 +35,7 @@
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "inet/networklayer/common/L3AddressTag_m.h"
 #include "inet/transportlayer/contract/udp/UdpControlInfo_m.h"
+#include "veins_inet/VeinsInetAggregationHeader_m.h"
 
 namespace veins {
 
@@ -56,14 +57,24 @@ void VeinsInetApplicationBase::initialize(int stage)
     ApplicationBase::initialize(stage);
 
     if (stage == INITSTAGE_LOCAL) {
+        aggregationWindow = par("aggregationWindow").doubleValue();
+        aggregationMaxLength = B(par("aggregationMaxLength").intValue());
+        reportDeadline = par("reportDeadline").doubleValue();
+        frameOverhead = par("frameOverhead").doubleValue();
     }
 }
 
 void VeinsInetApplicationBase::handleStartOperation(LifecycleOperation* operation)
 {
     mobility = veins::VeinsInetMobilityAccess().get(getParentModule());
+    manager = veins::VeinsInetManagerBaseAccess().get();
     traci = mobility->getCommandInterface();
     traciVehicle = mobility->getVehicleCommandInterface();
+    if (manager && manager->isPipelined()) {
+        // the connection is busy with the next time step, talk to TraCI only via the manager
+        traci = nullptr;
+        traciVehicle = nullptr;
+    }
 
     L3AddressResolver().tryResolve("224.0.0.1", destAddress);
     ASSERT(!destAddress.isUnspecified());
@@ -108,17 +119,33 @@ void VeinsInetApplicationBase::handleStopOperation(LifecycleOperation* operation
     bool ok = stopApplication();
     ASSERT(ok);
 
+    flushAggregationBuffer();
+    timerManager.reset(new veins::TimerManager(this));
     socket.close();
 }
 
 void VeinsInetApplicationBase::handleCrashOperation(LifecycleOperation* operation)
 {
+    aggregationBuffer.clear();
+    aggregationHoldStarts.clear();
+    aggregationBufferLength = B(0);
+    aggregationTimerPending = false;
+    timerManager.reset(new veins::TimerManager(this));
     socket.destroy();
 }
 
 void VeinsInetApplicationBase::finish()
 {
     ApplicationBase::finish();
+
+    if (aggregationWindow > 0) {
+        recordScalar("aggregatedFrames", aggregatedFrames);
+        recordScalar("aggregatedReports", aggregatedReports);
+        recordScalar("framesSaved", aggregatedReports - aggregatedFrames);
+        recordScalar("airtimeSaved", frameOverhead * (aggregatedReports - aggregatedFrames), "s");
+        recordScalar("deadlineViolations", deadlineViolations);
+    }
+    recordScalar("traciQueriesAvoided", traciQueriesAvoided);
 }
 
 VeinsInetApplicationBase::~VeinsInetApplicationBase()
@@ -131,14 +158,12 @@ void VeinsInetApplicationBase::refreshDisplay() const
 {
     ApplicationBase::refreshDisplay();
 
-    char buf[100];
-    sprintf(buf, "okay");
-    getDisplayString().setTagArg("t", 0, buf);
+    getDisplayString().setTagArg("t", 0, "okay");
 }
 
 void VeinsInetApplicationBase::handleMessageWhenUp(cMessage* msg)
 {
-    if (timerManager.handleMessage(msg)) return;
+    if (timerManager->handleMessage(msg)) return;
 
     if (msg->isSelfMessage()) {
         throw cRuntimeError("This module does not use custom self messages");
@@ -162,6 +187,17 @@ void VeinsInetApplicationBase::socketDataArrived(UdpSocket* socket, Packet* pack
     // statistics
     emit(packetReceivedSignal, pk.get());
 
+    // unpack aggregated reports, process them one by one (every frame holds a header when aggregating)
+    if (aggregationWindow > 0) {
+        auto header = pk->popAtFront<VeinsInetAggregationHeader>();
+        for (size_t i = 0; i < header->getReportLengthsArraySize(); i++) {
+            auto report = std::make_shared<inet::Packet>(pk->getName(), pk->popAtFront(B(header->getReportLengths(i))));
+            report->copyTags(*pk);
+            processPacket(report);
+        }
+        return;
+    }
+
     // process incoming packet
     processPacket(pk);
 }
@@ -200,14 +236,101 @@ void VeinsInetApplicationBase::speedPayload(inet::Ptr<inet::Chunk> payload)
 }
 
 void VeinsInetApplicationBase::sendPacket(std::unique_ptr<inet::Packet> pk)
+{
+    if (aggregationWindow <= 0) {
+        sendFrame(std::move(pk));
+        return;
+    }
+
+    B length = B(pk->getByteLength());
+    if (aggregationBufferLength + length > aggregationMaxLength) flushAggregationBuffer();
+    if (aggregationBuffer.empty()) {
+        auto callback = [this]() {
+            aggregationTimerPending = false;
+            flushAggregationBuffer();
+        };
+        aggregationTimer = timerManager->create(veins::TimerSpecification(callback).oneshotIn(aggregationWindow));
+        aggregationTimerPending = true;
+    }
+    aggregationBufferLength += length;
+    aggregationBuffer.push_back(std::move(pk));
+    aggregationHoldStarts.push_back(simTime());
+}
+
+void VeinsInetApplicationBase::flushAggregationBuffer()
+{
+    if (aggregationBuffer.empty()) return;
+    if (aggregationTimerPending) {
+        timerManager->cancel(aggregationTimer);
+        aggregationTimerPending = false;
+    }
+
+    // only the time spent here counts, not how old a forwarded report already was
+    for (auto holdStart : aggregationHoldStarts) {
+        if (simTime() - holdStart > reportDeadline) deadlineViolations++;
+    }
+
+    auto header = makeShared<VeinsInetAggregationHeader>();
+    header->setReportLengthsArraySize(aggregationBuffer.size());
+    for (size_t i = 0; i < aggregationBuffer.size(); i++) {
+        header->setReportLengths(i, aggregationBuffer[i]->getByteLength());
+    }
+    header->setChunkLength(B(2 + 2 * aggregationBuffer.size()));
+
+    // request tags (e.g., transmission power) of the first packet apply to the frame
+    auto frame = createPacket(aggregationBuffer.size() == 1 ? aggregationBuffer.front()->getName() : "aggregate");
+    frame->copyTags(*aggregationBuffer.front());
+    frame->insertAtBack(header);
+    for (auto& pk : aggregationBuffer) {
+        frame->insertAtBack(pk->peekData());
+    }
+
+    if (aggregationBuffer.size() > 1) {
+        aggregatedFrames++;
+        aggregatedReports += aggregationBuffer.size();
+    }
+    sendFrame(std::move(frame));
+
+    aggregationBuffer.clear();
+    aggregationHoldStarts.clear();
+    aggregationBufferLength = B(0);
+}
+
+void VeinsInetApplicationBase::sendFrame(std::unique_ptr<inet::Packet> pk)
 {
     emit(packetSentSignal, pk.get());
     socket.sendTo(pk.release(), destAddress, portNumber);
 }
+
+const VeinsInetMobility::VehicleSnapshot& VeinsInetApplicationBase::getVehicleSnapshot() const
+{
+    // also valid without a TraCI connection (e.g., when replaying a trace or pipelined)
+    return mobility->getVehicleSnapshot();
+}
+
+void VeinsInetApplicationBase::setVehicleSpeed(double speed)
+{
+    // without a TraCI connection of its own (e.g., in a network partition of a parallel simulation), the manager knows where to send commands
+    if (manager && (manager->isBatchingVehicleCommands() || manager->isPipelined() || !traciVehicle)) {
+        manager->setVehicleSpeed(mobility->getExternalId(), speed);
+        return;
+    }
+    if (traciVehicle) traciVehicle->setSpeed(speed);
+}
+
+void VeinsInetApplicationBase::changeVehicleRoute(const std::string& roadId, double travelTime)
+{
+    if (manager && (manager->isBatchingVehicleCommands() || manager->isPipelined() || !traciVehicle)) {
+        manager->changeVehicleRoute(mobility->getExternalId(), roadId, travelTime);
+        return;
+    }
+    if (traciVehicle) traciVehicle->changeRoute(roadId, travelTime);
+}
+
 //Packet(const char *name, const Ptr<const Chunk>& content);
-std::unique_ptr<inet::Packet> VeinsInetApplicationBase::createPacket(std::string name)
+std::unique_ptr<inet::Packet> VeinsInetApplicationBase::createPacket(const char* name)
 {
-    return std::unique_ptr<Packet>(new Packet(name.c_str()));
+    return std::unique_ptr<Packet>(new Packet(name));
 }
 
 void VeinsInetApplicationBase::processPacket(std::shared_ptr<inet::Packet> pk)
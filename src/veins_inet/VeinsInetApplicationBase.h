@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "veins_inet/veins_inet.h"
@@ -30,6 +31,7 @@
 
 #include "inet/applications/base/ApplicationBase.h"
 #include "inet/transportlayer/contract/udp/UdpSocket.h"
+#include "veins_inet/VeinsInetManagerBase.h"
 #include "veins_inet/VeinsInetMobility.h"
 #include "veins/modules/utility/TimerManager.h"
 
@@ -38,14 +40,29 @@ namespace veins {
 class VEINS_INET_API VeinsInetApplicationBase : public inet::ApplicationBase, public inet::UdpSocket::ICallback {
 protected:
     veins::VeinsInetMobility* mobility;
+    veins::VeinsInetManagerBase* manager = nullptr;
     veins::TraCICommandInterface* traci;
-    veins::TraCICommandInterface::Vehicle* traciVehicle;
-    veins::TimerManager timerManager{this};
+    veins::TraCICommandInterface::Vehicle* traciVehicle; /**< nullptr if the manager is not connected to a TraCI server or pipelined */
+    std::unique_ptr<veins::TimerManager> timerManager{new veins::TimerManager(this)}; /**< replaced on stop, dropping all pending timers */
 
     inet::L3Address destAddress;
     const int portNumber = 9001;
     inet::UdpSocket socket;
 
+    simtime_t aggregationWindow; /**< how long to hold outgoing packets to send them in one frame (not at all, if not positive) */
+    inet::B aggregationMaxLength; /**< frame length that, if exceeded, makes held packets be sent right away */
+    simtime_t reportDeadline; /**< time aggregation should hold a report at most */
+    simtime_t frameOverhead; /**< airtime every frame costs besides its payload, for estimating the savings of aggregation */
+    std::vector<std::unique_ptr<inet::Packet>> aggregationBuffer; /**< packets held to be sent in one frame */
+    std::vector<simtime_t> aggregationHoldStarts; /**< time each packet in aggregationBuffer was handed to sendPacket() */
+    inet::B aggregationBufferLength = inet::B(0);
+    veins::TimerHandle aggregationTimer;
+    bool aggregationTimerPending = false;
+    uint64_t aggregatedFrames = 0; /**< number of frames sent holding more than one packet */
+    uint64_t aggregatedReports = 0; /**< number of packets sent in such frames */
+    uint64_t deadlineViolations = 0; /**< number of packets held longer than reportDeadline by aggregation */
+    uint64_t traciQueriesAvoided = 0; /**< number of TraCI queries saved by reading the vehicle snapshot instead */
+
 protected:
     virtual int numInitStages() const override;
     virtual void initialize(int stage) override;
@@ -63,14 +80,46 @@ protected:
     virtual void socketErrorArrived(inet::UdpSocket* socket, inet::Indication* indication) override;
     virtual void socketClosed(inet::UdpSocket* socket) override;
 
-    virtual std::unique_ptr<inet::Packet> createPacket(std::string name);
+    /**
+     * Returns a new packet; pass a string constant as name, OMNeT++ shares it instead of copying it
+     */
+    virtual std::unique_ptr<inet::Packet> createPacket(const char* name);
     virtual void processPacket(std::shared_ptr<inet::Packet> pk);
     virtual void timestampPayload(inet::Ptr<inet::Chunk> payload);
 
     virtual void speedPayload(inet::Ptr<inet::Chunk> payload);
 
+    /**
+     * Sends a packet, or holds it to send it together with those that follow within aggregationWindow
+     */
     virtual void sendPacket(std::unique_ptr<inet::Packet> pk);
 
+    /**
+     * Sends all held packets in one frame, preceded by a VeinsInetAggregationHeader (also if there is only one, so receivers need not probe for it)
+     */
+    virtual void flushAggregationBuffer();
+
+    /**
+     * Hands a frame to the socket
+     */
+    virtual void sendFrame(std::unique_ptr<inet::Packet> pk);
+
+    /**
+     * Returns the state of this vehicle as of the last TraCI update, as handed to its mobility module by the manager.
+     * Read this instead of querying TraCI (each getter of traciVehicle is a round trip to SUMO), and add the queries saved to traciQueriesAvoided.
+     */
+    virtual const veins::VeinsInetMobility::VehicleSnapshot& getVehicleSnapshot() const;
+
+    /**
+     * Changes the speed of this vehicle (-1 to hand control back to SUMO), via the manager if it batches vehicle commands, is pipelined, or there is no TraCI connection
+     */
+    virtual void setVehicleSpeed(double speed);
+
+    /**
+     * Sets the travel time of a road for this vehicle and reroutes it, via the manager if it batches vehicle commands, is pipelined, or there is no TraCI connection
+     */
+    virtual void changeVehicleRoute(const std::string& roadId, double travelTime);
+
 public:
     VeinsInetApplicationBase();
     ~VeinsInetApplicationBase();
@@ -0,0 +1,220 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetBeaconApplication.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "inet/common/packet/Packet.h"
+#if INET_VERSION >= 0x0404
+#include "inet/physicallayer/wireless/common/contract/packetlevel/IRadio.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+#else
+#include "inet/physicallayer/contract/packetlevel/IRadio.h"
+#include "inet/physicallayer/contract/packetlevel/SignalTag_m.h"
+#endif
+
+#include "veins_inet/VeinsInetBeaconMessage_m.h"
+
+using namespace inet;
+using inet::physicallayer::IRadio;
+using veins::VeinsInetBeaconApplication;
+
+Define_Module(veins::VeinsInetBeaconApplication);
+
+simsignal_t VeinsInetBeaconApplication::cbrSignal = registerSignal("cbr");
+simsignal_t VeinsInetBeaconApplication::beaconIntervalSignal = registerSignal("beaconInterval");
+simsignal_t VeinsInetBeaconApplication::txPowerSignal = registerSignal("txPower");
+simsignal_t VeinsInetBeaconApplication::interReceptionTimeSignal = registerSignal("interReceptionTime");
+
+bool VeinsInetBeaconApplication::startApplication()
+{
+    checkInterval = par("checkInterval").doubleValue();
+    minInterval = par("minInterval").doubleValue();
+    maxInterval = par("maxInterval").doubleValue();
+    positionThreshold = par("positionThreshold");
+    speedThreshold = par("speedThreshold");
+    headingThreshold = par("headingThreshold").doubleValue() * M_PI / 180;
+    beaconLength = B(par("beaconLength").intValue());
+
+    dcc = par("dcc");
+    cbrInterval = par("cbrInterval").doubleValue();
+    targetCbr = par("targetCbr");
+    dccAlpha = par("dccAlpha");
+    dccBeta = par("dccBeta");
+    minDutyCycle = par("minDutyCycle");
+    maxDutyCycle = par("maxDutyCycle");
+    minPower = par("minPower").doubleValue();
+    maxPower = par("maxPower").doubleValue();
+    powerStep = std::pow(10.0, par("powerStep").doubleValue() / 10);
+
+    dutyCycle = maxDutyCycle;
+    airtime = par("initialAirtime").doubleValue();
+    dccInterval = minInterval;
+    power = maxPower;
+    lastBeaconTime = -1;
+    lastReception.clear();
+
+    if (!radio) {
+        radio = getModuleByPath(par("radioModule"));
+        radio->subscribe(IRadio::receptionStateChangedSignal, this);
+        radio->subscribe(IRadio::transmissionStateChangedSignal, this);
+    }
+    busySince = simTime();
+    busyTime = 0;
+
+    // spread the first beacons of vehicles entering at the same time
+    auto check = [this]() { checkBeaconGeneration(); };
+    timerManager->create(veins::TimerSpecification(check).interval(checkInterval).relativeStart(uniform(0, checkInterval.dbl())));
+    if (dcc) {
+        auto measure = [this]() { updateCbr(); };
+        timerManager->create(veins::TimerSpecification(measure).interval(cbrInterval));
+    }
+
+    return true;
+}
+
+bool VeinsInetBeaconApplication::stopApplication()
+{
+    return true;
+}
+
+void VeinsInetBeaconApplication::receiveSignal(cComponent* source, simsignal_t signalID, intval_t value, cObject* details)
+{
+    accountBusyTime();
+
+    if (signalID == IRadio::receptionStateChangedSignal) {
+        receiving = value == IRadio::RECEPTION_STATE_BUSY || value == IRadio::RECEPTION_STATE_RECEIVING;
+    }
+    else if (signalID == IRadio::transmissionStateChangedSignal) {
+        bool wasTransmitting = transmitting;
+        transmitting = value == IRadio::TRANSMISSION_STATE_TRANSMITTING;
+        if (transmitting && !wasTransmitting) {
+            transmissionStart = simTime();
+        }
+        else if (wasTransmitting && !transmitting) {
+            airtime = 0.9 * airtime + 0.1 * (simTime() - transmissionStart);
+        }
+    }
+}
+
+void VeinsInetBeaconApplication::accountBusyTime()
+{
+    simtime_t now = simTime();
+    if (receiving || transmitting) busyTime += now - busySince;
+    busySince = now;
+}
+
+void VeinsInetBeaconApplication::updateCbr()
+{
+    accountBusyTime();
+    double measured = std::min(1.0, busyTime / cbrInterval);
+    busyTime = 0;
+
+    cbr = (measured + lastCbr) / 2;
+    lastCbr = measured;
+    emit(cbrSignal, cbr);
+
+    dutyCycle = (1 - dccAlpha) * dutyCycle + dccBeta * (targetCbr - cbr);
+    dutyCycle = std::max(minDutyCycle, std::min(maxDutyCycle, dutyCycle));
+    dccInterval = std::max(minInterval, std::min(maxInterval, airtime / dutyCycle));
+
+    // rate alone cannot relieve the channel any more, or it is clear again
+    if (cbr > targetCbr && dccInterval >= maxInterval) {
+        power = std::max(minPower, power / powerStep);
+    }
+    else if (cbr < targetCbr && dccInterval <= minInterval) {
+        power = std::min(maxPower, power * powerStep);
+    }
+}
+
+double VeinsInetBeaconApplication::getHeading(const inet::Coord& velocity) const
+{
+    // a standing vehicle keeps the heading it had
+    if (velocity.length() < speedThreshold) return lastHeading;
+    return std::atan2(velocity.y, velocity.x);
+}
+
+void VeinsInetBeaconApplication::checkBeaconGeneration()
+{
+    simtime_t now = simTime();
+    if (lastBeaconTime >= 0) {
+        simtime_t elapsed = now - lastBeaconTime;
+        if (elapsed < dccInterval) return;
+
+        inet::Coord position = mobility->getCurrentPosition();
+        inet::Coord velocity = mobility->getCurrentVelocity();
+        double headingChange = std::abs(std::remainder(getHeading(velocity) - lastHeading, 2 * M_PI));
+        bool triggered = elapsed >= maxInterval || position.distance(lastPosition) > positionThreshold || std::abs(velocity.length() - lastSpeed) > speedThreshold || headingChange > headingThreshold;
+        if (!triggered) return;
+
+        emit(beaconIntervalSignal, elapsed);
+    }
+
+    sendBeacon();
+}
+
+void VeinsInetBeaconApplication::sendBeacon()
+{
+    inet::Coord position = mobility->getCurrentPosition();
+    inet::Coord velocity = mobility->getCurrentVelocity();
+
+    lastBeaconTime = simTime();
+    lastPosition = position;
+    lastSpeed = velocity.length();
+    lastHeading = getHeading(velocity);
+
+    auto payload = makeShared<VeinsInetBeaconMessage>();
+    payload->setChunkLength(beaconLength);
+    payload->setStationId(getParentModule()->getId());
+    payload->setSequenceNumber(nextSequenceNumber++);
+    payload->setX(position.x);
+    payload->setY(position.y);
+    payload->setSpeed(lastSpeed);
+    payload->setHeading(lastHeading);
+    timestampPayload(payload);
+
+    auto packet = createPacket("beacon");
+    packet->insertAtBack(payload);
+    if (dcc) {
+        packet->addTagIfAbsent<SignalPowerReq>()->setPower(mW(power));
+        emit(txPowerSignal, power);
+    }
+    sendPacket(std::move(packet));
+}
+
+void VeinsInetBeaconApplication::processPacket(std::shared_ptr<inet::Packet> pk)
+{
+    // the application owns its port, so everything arriving there is a beacon
+    auto payload = pk->peekAtFront<VeinsInetBeaconMessage>();
+
+    simtime_t now = simTime();
+    auto i = lastReception.find(payload->getStationId());
+    if (i == lastReception.end()) {
+        lastReception.emplace(payload->getStationId(), now);
+        return;
+    }
+    emit(interReceptionTimeSignal, now - i->second);
+    i->second = now;
+}
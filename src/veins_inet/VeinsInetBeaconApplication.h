@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <unordered_map>
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins_inet/VeinsInetApplicationBase.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Sends periodic awareness beacons in the style of ETSI CAMs, rate and power controlled by decentralized congestion control (DCC).
+ *
+ * Every checkInterval, a beacon is generated if the vehicle moved, changed its speed, or changed its heading by more than a threshold since the last one,
+ * or if maxInterval has passed. Beacons are never sent more often than the DCC controller allows.
+ *
+ * The controller measures the channel busy ratio (CBR) from the state of the radio every cbrInterval and adapts the duty cycle of this host
+ * towards targetCbr (LIMERIC: delta = (1 - alpha) * delta + beta * (targetCbr - CBR)), which bounds the beacon interval from below.
+ * If the channel stays busy even at the longest interval, it lowers the transmission power, and raises it again once the channel is clear.
+ */
+class VEINS_INET_API VeinsInetBeaconApplication : public VeinsInetApplicationBase, public cListener {
+protected:
+    simtime_t checkInterval; /**< how often to check the generation rules */
+    simtime_t minInterval; /**< shortest interval between beacons */
+    simtime_t maxInterval; /**< longest interval between beacons */
+    double positionThreshold; /**< distance (m) moved that triggers a beacon */
+    double speedThreshold; /**< speed change (m/s) that triggers a beacon */
+    double headingThreshold; /**< heading change (rad) that triggers a beacon, while moving */
+    inet::B beaconLength;
+
+    bool dcc = false; /**< whether to adapt rate and power to the channel load */
+    simtime_t cbrInterval; /**< period the channel busy ratio is measured over */
+    double targetCbr;
+    double dccAlpha;
+    double dccBeta;
+    double minDutyCycle;
+    double maxDutyCycle;
+    double minPower; /**< transmission power (mW) not to go below */
+    double maxPower; /**< transmission power (mW) not to go above */
+    double powerStep; /**< factor to lower or raise the transmission power by */
+
+    uint32_t nextSequenceNumber = 0;
+    simtime_t lastBeaconTime = -1;
+    inet::Coord lastPosition;
+    double lastSpeed = 0;
+    double lastHeading = 0;
+
+    cModule* radio = nullptr; /**< radio whose state the channel busy ratio is measured from */
+    bool receiving = false; /**< whether the radio senses the channel busy or receives */
+    bool transmitting = false;
+    simtime_t busySince; /**< start of the current busy period, or of the measurement period, whatever is later */
+    simtime_t busyTime; /**< time the channel was busy in the current measurement period */
+    simtime_t transmissionStart;
+    double lastCbr = 0;
+    double cbr = 0; /**< channel busy ratio, averaged over the last two measurement periods */
+
+    double dutyCycle; /**< share of time this host may transmit (LIMERIC) */
+    simtime_t airtime; /**< smoothed duration of a transmission of this host */
+    simtime_t dccInterval; /**< shortest interval between beacons that keeps to dutyCycle */
+    double power; /**< current transmission power (mW) */
+
+    std::unordered_map<int, simtime_t> lastReception; /**< time the last beacon of every other host was received */
+
+    static simsignal_t cbrSignal;
+    static simsignal_t beaconIntervalSignal;
+    static simsignal_t txPowerSignal;
+    static simsignal_t interReceptionTimeSignal;
+
+protected:
+    virtual bool startApplication() override;
+    virtual bool stopApplication() override;
+    virtual void processPacket(std::shared_ptr<inet::Packet> pk) override;
+
+    virtual void receiveSignal(cComponent* source, simsignal_t signalID, intval_t value, cObject* details) override;
+
+    /** @brief sends a beacon if the generation rules say so */
+    virtual void checkBeaconGeneration();
+
+    virtual void sendBeacon();
+
+    /** @brief closes the current measurement period and adapts duty cycle and power to the channel busy ratio */
+    virtual void updateCbr();
+
+    /** @brief adds the busy time up to now to busyTime */
+    void accountBusyTime();
+
+    /** @brief returns the current direction of travel (OMNeT++ coordinates, in rad) */
+    double getHeading(const inet::Coord& velocity) const;
+};
+
+} // namespace veins
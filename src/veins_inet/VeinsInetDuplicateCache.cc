@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetDuplicateCache.h"
+
+using veins::VeinsInetDuplicateCache;
+
+VeinsInetDuplicateCache::VeinsInetDuplicateCache(size_t capacity, simtime_t lifetime)
+    : lifetime(lifetime)
+    , ring(capacity)
+{
+    if (capacity == 0) throw cRuntimeError("Duplicate cache needs a capacity of at least one message");
+    index.reserve(capacity);
+}
+
+bool VeinsInetDuplicateCache::checkAndInsert(int origin, uint32_t sequenceNumber, simtime_t now)
+{
+    uint64_t key = makeKey(origin, sequenceNumber);
+
+    auto i = index.find(key);
+    if (i != index.end()) {
+        Entry& entry = ring[i->second];
+        if (now - entry.time <= lifetime) return true;
+        // expired: forget it here, it is stored anew below
+        entry.used = false;
+        index.erase(i);
+    }
+
+    Entry& entry = ring[next];
+    if (entry.used) {
+        index.erase(entry.key);
+        if (now - entry.time <= lifetime) evictions++;
+    }
+    entry.key = key;
+    entry.time = now;
+    entry.used = true;
+    index[key] = next;
+    next = (next + 1) % ring.size();
+
+    return false;
+}
+
+void VeinsInetDuplicateCache::clear()
+{
+    for (auto& entry : ring) {
+        entry.used = false;
+    }
+    next = 0;
+    index.clear();
+}
+
+size_t VeinsInetDuplicateCache::getMemoryUsage() const
+{
+    // every map node holds its value and a link to the next node, plus its cached hash
+    size_t node = sizeof(std::pair<const uint64_t, size_t>) + 2 * sizeof(void*);
+    return sizeof(*this) + ring.size() * (sizeof(Entry) + node) + index.bucket_count() * sizeof(void*);
+}
@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Fixed-size set of the (origin, sequence number) identities of recently seen messages, for forwarding every message of a flood only once.
+ *
+ * Identities are kept in a ring buffer of capacity entries: once full, the oldest one is forgotten to make room.
+ * Identities older than lifetime count as unseen, so an origin may reuse sequence numbers after that long.
+ */
+class VEINS_INET_API VeinsInetDuplicateCache {
+public:
+    VeinsInetDuplicateCache(size_t capacity, simtime_t lifetime);
+
+    /**
+     * Returns true if the identity was seen within lifetime, else remembers it and returns false
+     */
+    bool checkAndInsert(int origin, uint32_t sequenceNumber, simtime_t now);
+
+    /**
+     * Forgets all identities (keeping the capacity and the eviction count)
+     */
+    void clear();
+
+    size_t size() const
+    {
+        return index.size();
+    }
+    size_t getCapacity() const
+    {
+        return ring.size();
+    }
+    /** @brief number of identities forgotten before their lifetime was over, to make room for new ones */
+    uint64_t getEvictions() const
+    {
+        return evictions;
+    }
+    /** @brief approximate number of bytes the cache occupies at most */
+    size_t getMemoryUsage() const;
+
+protected:
+    struct Entry {
+        uint64_t key = 0;
+        simtime_t time;
+        bool used = false;
+    };
+
+    static uint64_t makeKey(int origin, uint32_t sequenceNumber)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(origin)) << 32) | sequenceNumber;
+    }
+
+protected:
+    simtime_t lifetime;
+    std::vector<Entry> ring;
+    size_t next = 0; /**< ring index the next identity is stored at */
+    std::unordered_map<uint64_t, size_t> index; /**< ring index of every remembered identity */
+    uint64_t evictions = 0;
+};
+
+} // namespace veins
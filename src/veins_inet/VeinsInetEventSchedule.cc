@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetEventSchedule.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using veins::VeinsInetEventSchedule;
+
+namespace {
+
+const char* getRequiredAttribute(const cXMLElement* e, const char* name)
+{
+    const char* value = e->getAttribute(name);
+    if (!value) throw cRuntimeError("Event is missing attribute \"%s\" at %s", name, e->getSourceLocation());
+    return value;
+}
+
+double parseDouble(const cXMLElement* e, const char* name)
+{
+    const char* value = getRequiredAttribute(e, name);
+    char* end;
+    double result = strtod(value, &end);
+    if (end == value || *end != '\0') throw cRuntimeError("Attribute \"%s\" of event is not a number: \"%s\" at %s", name, value, e->getSourceLocation());
+    return result;
+}
+
+} // namespace
+
+void VeinsInetEventSchedule::load(const cXMLElement* root)
+{
+    for (auto e : root->getChildrenByTagName("event")) {
+        size_t i = events.size();
+        events.push_back(parseEvent(e));
+
+        const char* vehicleId = e->getAttribute("vehicle");
+        const char* hostIndex = e->getAttribute("index");
+        if ((vehicleId != nullptr) == (hostIndex != nullptr)) throw cRuntimeError("Event must select its vehicle by either \"vehicle\" or \"index\" at %s", e->getSourceLocation());
+        if (vehicleId) {
+            eventsByVehicleId[vehicleId].push_back(i);
+        }
+        else {
+            eventsByHostIndex[static_cast<int>(parseDouble(e, "index"))].push_back(i);
+        }
+    }
+
+    // hosts schedule their timers in order; position triggers are checked on every move, after all timed events
+    auto firesBefore = [this](size_t a, size_t b) {
+        simtime_t ta = events[a].isTimed() ? events[a].time : SimTime::getMaxTime();
+        simtime_t tb = events[b].isTimed() ? events[b].time : SimTime::getMaxTime();
+        return ta < tb;
+    };
+    for (auto& entry : eventsByVehicleId) {
+        std::stable_sort(entry.second.begin(), entry.second.end(), firesBefore);
+    }
+    for (auto& entry : eventsByHostIndex) {
+        std::stable_sort(entry.second.begin(), entry.second.end(), firesBefore);
+    }
+}
+
+void VeinsInetEventSchedule::getEvents(const std::string& vehicleId, int hostIndex, std::vector<const Event*>& result) const
+{
+    auto i = eventsByVehicleId.find(vehicleId);
+    if (i != eventsByVehicleId.end()) {
+        for (size_t pos : i->second) result.push_back(&events[pos]);
+    }
+    auto j = eventsByHostIndex.find(hostIndex);
+    if (j != eventsByHostIndex.end()) {
+        for (size_t pos : j->second) result.push_back(&events[pos]);
+    }
+}
+
+VeinsInetEventSchedule::Event VeinsInetEventSchedule::parseEvent(const cXMLElement* e) const
+{
+    Event event;
+
+    if (e->getAttribute("time")) {
+        event.time = SimTime::parse(e->getAttribute("time"));
+        if (event.time < 0) throw cRuntimeError("Event time must not be negative at %s", e->getSourceLocation());
+    }
+    else {
+        event.position = inet::Coord(parseDouble(e, "x"), parseDouble(e, "y"));
+        event.radius = parseDouble(e, "radius");
+        if (event.radius < 0) throw cRuntimeError("Event radius must not be negative at %s", e->getSourceLocation());
+    }
+
+    const char* action = getRequiredAttribute(e, "action");
+    if (strcmp(action, "stop") == 0) {
+        event.action = Action::STOP;
+        if (e->getAttribute("duration")) event.duration = SimTime::parse(e->getAttribute("duration"));
+    }
+    else if (strcmp(action, "resume") == 0) {
+        event.action = Action::RESUME;
+    }
+    else if (strcmp(action, "setSpeed") == 0) {
+        event.action = Action::SET_SPEED;
+        event.speed = parseDouble(e, "speed");
+    }
+    else if (strcmp(action, "warn") == 0) {
+        event.action = Action::WARN;
+        event.message = getRequiredAttribute(e, "message");
+        if (e->getAttribute("humidity")) event.humidity = static_cast<int>(parseDouble(e, "humidity"));
+        if (event.humidity < 0 || event.humidity > 255) throw cRuntimeError("Event humidity must be between 0 and 255 at %s", e->getSourceLocation());
+    }
+    else {
+        throw cRuntimeError("Unknown event action \"%s\" (expected stop, resume, setSpeed, or warn) at %s", action, e->getSourceLocation());
+    }
+
+    if (e->getAttribute("color")) event.color = e->getAttribute("color");
+
+    return event;
+}
@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "inet/common/geometry/common/Coord.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Scripted incidents (stopping, resuming, sending warnings) of vehicles, loaded once from an XML document, e.g.:
+ *
+ * <pre>
+ * <events>
+ *     <event index="0" time="15s" action="stop" duration="12s" color="green"/>
+ *     <event index="0" time="15s" action="warn" message="obstacle!" humidity="80"/>
+ *     <event vehicle="flow0.3" x="1200" y="450" radius="20" action="setSpeed" speed="5"/>
+ * </events>
+ * </pre>
+ *
+ * An event selects its vehicle by SUMO id (vehicle) or by index of the host module (index), and fires either at a time or when the vehicle first comes within radius of a position.
+ * Events are indexed by vehicle and sorted by time on loading, so a host only ever looks at its own events.
+ */
+class VEINS_INET_API VeinsInetEventSchedule {
+public:
+    enum class Action {
+        STOP, /**< stop the vehicle, resuming after duration (if positive) */
+        RESUME, /**< hand control of the speed back to SUMO */
+        SET_SPEED, /**< drive at speed */
+        WARN, /**< send a warning message */
+    };
+
+    struct Event {
+        simtime_t time = -1; /**< time to fire at, negative if triggered by position */
+        inet::Coord position; /**< center of the trigger area (position triggers only) */
+        double radius = -1; /**< radius of the trigger area, negative if triggered by time */
+        Action action = Action::WARN;
+        simtime_t duration; /**< how long to stop (STOP only) */
+        double speed = -1; /**< speed to drive at (SET_SPEED only) */
+        std::string message; /**< name of the message to send (WARN only) */
+        int humidity = 0; /**< road humidity to report (WARN only) */
+        std::string color; /**< color to give the host icon when firing, if not empty */
+
+        bool isTimed() const
+        {
+            return time >= 0;
+        }
+    };
+
+    /** @brief reads all event elements below root, throwing on malformed ones */
+    void load(const cXMLElement* root);
+
+    /** @brief appends the events of a vehicle, as selected by SUMO id or host index, each group ordered by time (position triggers last) */
+    void getEvents(const std::string& vehicleId, int hostIndex, std::vector<const Event*>& result) const;
+
+    size_t size() const
+    {
+        return events.size();
+    }
+
+    /** @brief whether any event selects its vehicle by host index */
+    bool hasIndexedEvents() const
+    {
+        return !eventsByHostIndex.empty();
+    }
+
+protected:
+    Event parseEvent(const cXMLElement* e) const;
+
+protected:
+    std::vector<Event> events;
+    std::unordered_map<std::string, std::vector<size_t>> eventsByVehicleId; /**< positions in events, by SUMO id of the vehicle */
+    std::unordered_map<int, std::vector<size_t>> eventsByHostIndex; /**< positions in events, by index of the host module */
+};
+
+} // namespace veins
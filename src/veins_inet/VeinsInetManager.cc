@@ -35,3 +35,9 @@ void VeinsInetManager::initialize(int stage)
     TraCIScenarioManagerLaunchd::initialize(stage);
     VeinsInetManagerBase::initialize(stage);
 }
+
+void VeinsInetManager::finish()
+{
+    finishRecording();
+    TraCIScenarioManagerLaunchd::finish();
+}
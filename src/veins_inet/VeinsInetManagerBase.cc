@@ -22,16 +22,120 @@
 
 #include "veins_inet/VeinsInetManagerBase.h"
 
+#include <algorithm>
+
 #include "veins/base/utils/Coord.h"
 #include "veins_inet/VeinsInetMobility.h"
+#include "veins_inet/VeinsInetRoadIdTable.h"
+#include "veins_inet/VeinsInetTraCIBatch.h"
+#include "veins_inet/VeinsInetTrace.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+#include "inet/common/lifecycle/ModuleOperations.h"
 #include "inet/common/scenario/ScenarioManager.h"
+#include "inet/mobility/contract/IMobility.h"
+
+using namespace veins::TraCIConstants;
 
+using veins::TraCIBuffer;
+using veins::TraCICoord;
 using veins::VeinsInetManagerBase;
+using veins::VeinsInetTraCIBatch;
+using veins::VeinsInetTraceWriter;
 
 Define_Module(veins::VeinsInetManagerBase);
 
+namespace {
+
+/**
+ * Parses a mapping from vehicle types to values like TraCIScenarioManager does: "vType=value vType=value ..." or a single value for all types
+ */
+std::map<std::string, std::string> parseTypeMapping(const char* parameterName, const std::string& parameter)
+{
+    std::map<std::string, std::string> mapping;
+    std::vector<std::string> entries = cStringTokenizer(parameter.c_str(), " ").asVector();
+    if (entries.size() == 1 && entries[0].find('=') == std::string::npos) {
+        mapping["*"] = entries[0];
+        return mapping;
+    }
+    for (auto& entry : entries) {
+        size_t separator = entry.find('=');
+        if (separator == std::string::npos) throw cRuntimeError("%s must be a single value or a list of vType=value pairs, not \"%s\"", parameterName, parameter.c_str());
+        mapping[entry.substr(0, separator)] = entry.substr(separator + 1);
+    }
+    return mapping;
+}
+
+std::string lookupTypeMapping(const std::map<std::string, std::string>& mapping, const std::string& vType)
+{
+    auto i = mapping.find(vType);
+    if (i == mapping.end()) i = mapping.find("*");
+    return i == mapping.end() ? "" : i->second;
+}
+
+/**
+ * Skips a value of a subscription result the pool does not need
+ */
+void skipTraCIValue(TraCIBuffer& buf, uint8_t type)
+{
+    switch (type) {
+    case TYPE_UBYTE:
+    case TYPE_BYTE:
+        buf.read<uint8_t>();
+        break;
+    case TYPE_INTEGER:
+        buf.read<int32_t>();
+        break;
+    case TYPE_DOUBLE:
+        buf.read<double>();
+        break;
+    case TYPE_STRING:
+        buf.read<std::string>();
+        break;
+    case TYPE_STRINGLIST:
+        for (uint32_t n = buf.read<uint32_t>(); n > 0; n--) buf.read<std::string>();
+        break;
+    case POSITION_2D:
+        buf.read<double>();
+        buf.read<double>();
+        break;
+    case POSITION_3D:
+        buf.read<double>();
+        buf.read<double>();
+        buf.read<double>();
+        break;
+    case TYPE_COLOR:
+        for (int n = 0; n < 4; n++) buf.read<uint8_t>();
+        break;
+    default:
+        throw cRuntimeError("Cannot skip subscription result of unknown type 0x%02x", type);
+    }
+}
+
+/**
+ * Takes one subscription result (including its length header) off a response, as a buffer of its own
+ */
+TraCIBuffer takeSubscriptionResult(TraCIBuffer& buf)
+{
+    // subscription results always have an extended length, which includes the length header itself
+    uint8_t cmdLength;
+    buf >> cmdLength;
+    ASSERT(cmdLength == 0);
+    uint32_t cmdLengthExt;
+    buf >> cmdLengthExt;
+    std::string result = (TraCIBuffer() << cmdLength << cmdLengthExt).str();
+    result.reserve(cmdLengthExt);
+    while (result.size() < cmdLengthExt) result += static_cast<char>(buf.read<uint8_t>());
+    return TraCIBuffer(result);
+}
+
+} // namespace
+
 VeinsInetManagerBase::~VeinsInetManagerBase()
 {
+    // states of vehicles removed after the last time step are never shipped
+    for (auto msg : partitionStates) {
+        delete msg;
+    }
 }
 
 void VeinsInetManagerBase::initialize(int stage)
@@ -39,6 +143,43 @@ void VeinsInetManagerBase::initialize(int stage)
     if (stage != 1)
         return;
 
+    batchedStateUpdates = par("batchedStateUpdates");
+    queryMaxSpeed = par("queryMaxSpeed");
+    batchedVehicleCommands = par("batchedVehicleCommands");
+    pipelinedStepping = par("pipelinedStepping");
+    if (pipelinedStepping && !batchedStateUpdates) throw cRuntimeError("pipelinedStepping requires batchedStateUpdates: applications cannot query TraCI while a time step is pending");
+    if (pipelinedStepping) {
+        stepOverlapVec.setName("stepOverlap");
+        stepOverlapVec.setUnit("s");
+        stepWaitVec.setName("stepWait");
+        stepWaitVec.setUnit("s");
+    }
+
+    poolModules = par("poolModules");
+    if (poolModules) {
+        // TraCIScenarioManager::addModule() decides which vehicles get a host by the number of hosts, which reused hosts would skew
+        if (par("penetrationRate").doubleValue() < 1) throw cRuntimeError("poolModules requires a penetrationRate of 1");
+        moduleTypes = parseTypeMapping("moduleType", par("moduleType").stdstringValue());
+        moduleNames = parseTypeMapping("moduleName", par("moduleName").stdstringValue());
+        minPoolHits = par("minPoolHits");
+    }
+
+    std::string traceRecordFile = par("traceRecordFile").stdstringValue();
+    if (!traceRecordFile.empty()) traceWriter.reset(new VeinsInetTraceWriter(traceRecordFile, updateInterval));
+
+    eventSchedule.load(par("eventSchedule").xmlValue());
+
+    int numPartitions = gateSize("partitionOut");
+    if (numPartitions > 0) {
+        partitionBoundaries = cStringTokenizer(par("partitionBoundaries")).asDoubleVector();
+        if (partitionBoundaries.size() + 1 != size_t(numPartitions)) throw cRuntimeError("partitionBoundaries must hold %d x coordinates to split the playground among %d network partitions", numPartitions - 1, numPartitions);
+        if (!std::is_sorted(partitionBoundaries.begin(), partitionBoundaries.end())) throw cRuntimeError("partitionBoundaries must be in ascending order");
+        partitionStates.resize(numPartitions, nullptr);
+        signalManager.subscribeCallback(this, TraCIScenarioManager::traciTimestepEndSignal, [this](SignalPayload<const simtime_t&> payload) {
+            shipVehicleStates();
+        });
+    }
+
 #if INET_VERSION >= 0x0402
     signalManager.subscribeCallback(this, TraCIScenarioManager::traciModulePreInitSignal, [this](SignalPayload<cObject*> payload) {
         cModule* module = dynamic_cast<cModule*>(payload.p);
@@ -51,16 +192,782 @@ void VeinsInetManagerBase::initialize(int stage)
         root->emit(POST_MODEL_CHANGE, notification, NULL);
     });
 #endif
+
+    signalManager.subscribeCallback(this, TraCIScenarioManager::traciModuleRemovedSignal, [this](SignalPayload<cObject*> payload) {
+        cModule* module = dynamic_cast<cModule*>(payload.p);
+        ASSERT(module);
+
+        auto i = vehicleHandles.find(module->getId());
+        if (i != vehicleHandles.end()) {
+            if (traceWriter) traceWriter->addRemove(i->second.nodeId);
+            if (i->second.partition >= 0) queueVehicleState(i->second.partition, VEHICLE_STATE_REMOVE, i->second);
+            if (i->second.slot >= 0) vehicleStore.release(i->second.slot);
+        }
+        if (spatialIndex) spatialIndex->remove(module);
+        vehicleHandles.erase(module->getId());
+    });
+
+    signalManager.subscribeCallback(this, TraCIScenarioManager::traciInitializedSignal, [this](SignalPayload<bool> payload) {
+        // number all roads in SUMO's order, so road indices are dense and do not depend on the order vehicles enter them
+        if (isConnected()) {
+            for (auto& roadId : commandIfc->getRoadIds()) {
+                VeinsInetRoadIdTable::getInstance().intern(roadId);
+            }
+        }
+
+        if (!attachRegionInitialized) initializeAttachRegion();
+        if (!spatialIndexInitialized) initializeSpatialIndex();
+
+        // do not even instantiate vehicles that are far from the region
+        double margin = par("roiMargin");
+        if (margin < 0 || attachRegion.empty()) return;
+        std::string rects;
+        for (auto& box : attachRegion.getBoundingBoxes()) {
+            TraCICoord a = connection->omnet2traci(Coord(box.first.x - margin, box.first.y - margin));
+            TraCICoord b = connection->omnet2traci(Coord(box.second.x + margin, box.second.y + margin));
+            rects += opp_stringf("%f,%f-%f,%f ", std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.x, b.x), std::max(a.y, b.y));
+        }
+        roi.addRectangles(rects);
+    });
+
+    signalManager.subscribeCallback(this, TraCIScenarioManager::traciModuleAddedSignal, [this](SignalPayload<cObject*> payload) {
+        cModule* module = dynamic_cast<cModule*>(payload.p);
+        ASSERT(module);
+
+        // host is fully initialized now, so its network stack can be stopped
+        VehicleHandle& handle = getVehicleHandle(module);
+        handle.attached = true;
+        updateAttachment(module, handle);
+    });
+
+    signalManager.subscribeCallback(this, TraCIScenarioManager::traciTimestepEndSignal, [this](SignalPayload<const simtime_t&> payload) {
+        // subscribe first, so the snapshots handed to VeinsInetMobility are complete for new vehicles, too
+        if (batchedStateUpdates) subscribeToVehicleStates();
+        updateVehicleKinematics();
+    });
+
+    // in pipelined mode, queued commands are sent by executePipelinedTimestep()
+    if (!pipelinedStepping) {
+        signalManager.subscribeCallback(this, TraCIScenarioManager::traciTimestepBeginSignal, [this](SignalPayload<const simtime_t&> payload) {
+            flushVehicleCommands();
+        });
+    }
+}
+
+void VeinsInetManagerBase::finish()
+{
+    finishRecording();
+    TraCIScenarioManager::finish();
+}
+
+void VeinsInetManagerBase::finishRecording()
+{
+    // leave the connection ready for further commands (e.g., closing it)
+    if (stepPending) {
+        connection->receiveMessage();
+        stepPending = false;
+    }
+
+    recordScalar("mobilityLookupsSaved", mobilityLookupsSaved);
+    if (batchedStateUpdates) {
+        recordScalar("stateSubscriptions", stateSubscriptions);
+        recordScalar("stateSubscriptionBatches", stateSubscriptionBatches);
+    }
+    recordScalar("vehicleCommandsSent", vehicleCommandsSent);
+    recordScalar("vehicleCommandsMerged", vehicleCommandsMerged);
+    if (pipelinedStepping) {
+        recordScalar("totalStepOverlap", totalStepOverlap, "s");
+        recordScalar("totalStepWait", totalStepWait, "s");
+    }
+    if (!attachRegion.empty()) {
+        recordScalar("stackAttaches", stackAttaches);
+        recordScalar("stackDetaches", stackDetaches);
+    }
+    if (!partitionStates.empty()) {
+        recordScalar("shippedStates", shippedStates);
+        recordScalar("partitionHandovers", partitionHandovers);
+        recordScalar("forwardedCommands", forwardedCommands);
+    }
+    if (traceWriter) {
+        recordScalar("traceRecords", traceWriter->getRecordCount());
+        traceWriter->close();
+        traceWriter.reset();
+    }
+    if (poolModules) {
+        recordScalar("poolRequests", poolRequests);
+        recordScalar("poolHits", poolHits);
+        recordScalar("poolHitRate", poolRequests > 0 ? double(poolHits) / poolRequests : 0);
+        recordScalar("peakPoolSize", peakPoolSize);
+        if (poolHits < static_cast<uint64_t>(std::max(minPoolHits, 0))) throw cRuntimeError("Only %lu of %lu hosts were reused from the pool, expected at least %d (see minPoolHits)", static_cast<unsigned long>(poolHits), static_cast<unsigned long>(poolRequests), minPoolHits);
+    }
+    clearModulePool();
+}
+
+const VeinsInetManagerBase::VehicleState* VeinsInetManagerBase::getVehicleState(const cModule* mod) const
+{
+    auto i = vehicleHandles.find(mod->getId());
+    if (i == vehicleHandles.end()) return nullptr;
+    return &i->second.state;
+}
+
+void VeinsInetManagerBase::subscribeToVehicleStates()
+{
+    if (pendingStateSubscriptions.empty()) return;
+    if (!isConnected()) {
+        pendingStateSubscriptions.clear();
+        return;
+    }
+
+    // SUMO would merge a subscription with the same time span into that of TraCIScenarioManager, so end this one a step earlier
+    simtime_t beginTime = 0;
+    simtime_t endTime = SimTime::getMaxTime() - updateInterval;
+    VeinsInetTraCIBatch batch(connection.get());
+    for (const auto& nodeId : pendingStateSubscriptions) {
+        batch.add(CMD_SUBSCRIBE_VEHICLE_VARIABLE, TraCIBuffer() << beginTime << endTime << nodeId << static_cast<uint8_t>(2) << VAR_ACCELERATION << VAR_LANE_INDEX);
+    }
+    stateSubscriptions += batch.size();
+    stateSubscriptionBatches++;
+
+    // every response holds the current values, later ones arrive with the time steps
+    TraCIBuffer buf = batch.execute();
+    for (size_t i = 0; i < pendingStateSubscriptions.size(); i++) {
+        VeinsInetTraCIBatch::readStatus(buf, CMD_SUBSCRIBE_VEHICLE_VARIABLE);
+        bool processed = processStateSubscription(takeSubscriptionResult(buf));
+        ASSERT(processed);
+    }
+    ASSERT(buf.eof());
+    pendingStateSubscriptions.clear();
+}
+
+bool VeinsInetManagerBase::processStateSubscription(TraCIBuffer buf)
+{
+    uint8_t cmdLength;
+    buf >> cmdLength;
+    uint32_t cmdLengthExt;
+    buf >> cmdLengthExt;
+    uint8_t commandId;
+    buf >> commandId;
+    if (commandId != RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE) return false;
+    std::string objectId;
+    buf >> objectId;
+    uint8_t variableCount;
+    buf >> variableCount;
+
+    // the subscription of TraCIScenarioManager starts with the position
+    uint8_t variableId;
+    buf >> variableId;
+    if (variableId != VAR_ACCELERATION) return false;
+
+    // the vehicle may have no host (e.g., outside the region of interest)
+    auto host = hosts.find(objectId);
+    VehicleHandle* handle = nullptr;
+    if (host != hosts.end()) {
+        auto i = vehicleHandles.find(host->second->getId());
+        if (i != vehicleHandles.end()) handle = &i->second;
+    }
+
+    for (uint8_t j = 0; j < variableCount; ++j) {
+        if (j > 0) buf >> variableId;
+        uint8_t status;
+        buf >> status;
+        uint8_t type;
+        buf >> type;
+        if (status == RTYPE_OK && handle && variableId == VAR_ACCELERATION && type == TYPE_DOUBLE) {
+            buf >> handle->state.acceleration;
+        }
+        else if (status == RTYPE_OK && handle && variableId == VAR_LANE_INDEX && type == TYPE_INTEGER) {
+            buf >> handle->state.laneIndex;
+        }
+        else {
+            // also the description of an error, e.g., for a vehicle that just arrived
+            skipTraCIValue(buf, type);
+        }
+    }
+    ASSERT(buf.eof());
+    return true;
+}
+
+void VeinsInetManagerBase::updateVehicleKinematics()
+{
+    vehicleStore.computeKinematics(simTime());
+
+    for (auto& entry : vehicleHandles) {
+        VehicleHandle& handle = entry.second;
+        if (!handle.moved) continue;
+        handle.moved = false;
+
+        if (!batchedStateUpdates) handle.state.acceleration = vehicleStore.getAcceleration(handle.slot);
+        for (auto inetmm : handle.mobilityModules) {
+            inetmm->nextPosition(vehicleStore, handle.slot, handle.state.road, handle.state.acceleration, handle.state.laneIndex);
+        }
+    }
+}
+
+void VeinsInetManagerBase::handleMessage(cMessage* msg)
+{
+    if (msg->isSelfMessage()) {
+        TraCIScenarioManager::handleMessage(msg);
+        return;
+    }
+    processVehicleCommand(check_and_cast<VeinsInetVehicleCommandMessage*>(msg));
+    delete msg;
+}
+
+void VeinsInetManagerBase::handleSelfMsg(cMessage* msg)
+{
+    if (pipelinedStepping && msg == executeOneTimestepTrigger) {
+        executePipelinedTimestep();
+        return;
+    }
+    // TraCIScenarioManager would hand the results of the state subscriptions to a parser that rejects them
+    if ((poolModules || batchedStateUpdates) && msg == executeOneTimestepTrigger) {
+        executeSubscribedTimestep();
+        return;
+    }
+    TraCIScenarioManager::handleSelfMsg(msg);
+}
+
+void VeinsInetManagerBase::executePipelinedTimestep()
+{
+    simtime_t targetTime = simTime();
+    EV_DEBUG << "Collecting TraCI server simulation advance to t=" << targetTime << endl;
+
+    emit(traciTimestepBeginSignal, targetTime);
+
+    if (isConnected()) {
+        // first step, nothing was requested in advance
+        if (!stepPending) {
+            connection->sendMessage(makeTraCICommand(CMD_SIMSTEP, TraCIBuffer() << targetTime));
+            stepRequestTime = std::chrono::steady_clock::now();
+            stepPending = true;
+            pendingStepTarget = targetTime;
+        }
+        ASSERT(pendingStepTarget == targetTime);
+
+        auto waitStart = std::chrono::steady_clock::now();
+        TraCIBuffer buf(connection->receiveMessage());
+        stepPending = false;
+        auto waitEnd = std::chrono::steady_clock::now();
+
+        double overlap = std::chrono::duration<double>(waitStart - stepRequestTime).count();
+        double wait = std::chrono::duration<double>(waitEnd - waitStart).count();
+        totalStepOverlap += overlap;
+        totalStepWait += wait;
+        stepOverlapVec.record(overlap);
+        stepWaitVec.record(wait);
+
+        VeinsInetTraCIBatch::readStatus(buf, CMD_SIMSTEP);
+        processStepResults(buf);
+    }
+
+    emit(traciTimestepEndSignal, targetTime);
+
+    if (!autoShutdownTriggered) {
+        simtime_t nextTargetTime = simTime() + updateInterval;
+        if (isConnected()) {
+            // commands queued from now on will only be sent before the step after next
+            flushVehicleCommands();
+            connection->sendMessage(makeTraCICommand(CMD_SIMSTEP, TraCIBuffer() << nextTargetTime));
+            stepRequestTime = std::chrono::steady_clock::now();
+            stepPending = true;
+            pendingStepTarget = nextTargetTime;
+        }
+        scheduleAt(nextTargetTime, executeOneTimestepTrigger);
+    }
+}
+
+void VeinsInetManagerBase::executeSubscribedTimestep()
+{
+    simtime_t targetTime = simTime();
+    EV_DEBUG << "Triggering TraCI server simulation advance to t=" << targetTime << endl;
+
+    emit(traciTimestepBeginSignal, targetTime);
+
+    if (isConnected()) {
+        TraCIBuffer buf = connection->query(CMD_SIMSTEP, TraCIBuffer() << targetTime);
+        processStepResults(buf);
+    }
+
+    emit(traciTimestepEndSignal, targetTime);
+
+    if (!autoShutdownTriggered) scheduleAt(simTime() + updateInterval, executeOneTimestepTrigger);
+}
+
+void VeinsInetManagerBase::processStepResults(TraCIBuffer& buf)
+{
+    uint32_t count;
+    buf >> count;
+    EV_DEBUG << "Getting " << count << " subscription results" << endl;
+    for (uint32_t i = 0; i < count; ++i) {
+        // a buffer per result, so the pre-passes copy only that result, not the rest of the response
+        TraCIBuffer result = takeSubscriptionResult(buf);
+        if (batchedStateUpdates && processStateSubscription(result)) continue;
+        if (poolModules) poolSubscribedModules(result);
+        processSubcriptionResult(result);
+        ASSERT(result.eof());
+    }
+    ASSERT(buf.eof());
+}
+
+void VeinsInetManagerBase::poolSubscribedModules(TraCIBuffer buf)
+{
+    uint8_t cmdLength;
+    buf >> cmdLength;
+    uint32_t cmdLengthExt;
+    buf >> cmdLengthExt;
+    uint8_t commandId;
+    buf >> commandId;
+    std::string objectId;
+    buf >> objectId;
+    uint8_t variableCount;
+    buf >> variableCount;
+
+    if (commandId == RESPONSE_SUBSCRIBE_SIM_VARIABLE) {
+        std::vector<std::string> departed;
+        for (uint8_t j = 0; j < variableCount; ++j) {
+            uint8_t variableId;
+            buf >> variableId;
+            uint8_t status;
+            buf >> status;
+            // errors are reported by TraCIScenarioManager
+            if (status != RTYPE_OK) return;
+            uint8_t type;
+            buf >> type;
+            if (variableId == VAR_DEPARTED_VEHICLES_IDS || variableId == VAR_TELEPORT_ENDING_VEHICLES_IDS) {
+                ASSERT(type == TYPE_STRINGLIST);
+                for (uint32_t n = buf.read<uint32_t>(); n > 0; n--) departed.push_back(buf.read<std::string>());
+                continue;
+            }
+            if (variableId != VAR_ARRIVED_VEHICLES_IDS && variableId != VAR_TELEPORT_STARTING_VEHICLES_IDS) {
+                skipTraCIValue(buf, type);
+                continue;
+            }
+            ASSERT(type == TYPE_STRINGLIST);
+            uint32_t count;
+            buf >> count;
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string nodeId;
+                buf >> nodeId;
+                // TraCIScenarioManager would delete the host, park it before it gets the chance
+                if (hosts.find(nodeId) != hosts.end()) parkHostModule(nodeId);
+                if (variableId == VAR_ARRIVED_VEHICLES_IDS) unequippedVehicles.erase(nodeId);
+            }
+        }
+        // after parking the hosts of this step's arrivals, so departures can reuse them right away
+        poolDepartedModules(departed);
+        return;
+    }
+
+    if (commandId != RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE) return;
+
+    bool managed = hosts.find(objectId) != hosts.end();
+    if (!managed && unequippedVehicles.find(objectId) != unequippedVehicles.end()) return;
+
+    TraCICoord position;
+    std::string roadId;
+    double speed = 0;
+    double angle = 0;
+    for (uint8_t j = 0; j < variableCount; ++j) {
+        uint8_t variableId;
+        buf >> variableId;
+        uint8_t status;
+        buf >> status;
+        if (status != RTYPE_OK) return;
+        uint8_t type;
+        buf >> type;
+        if (variableId == VAR_POSITION && type == POSITION_2D) {
+            buf >> position.x;
+            buf >> position.y;
+        }
+        else if (variableId == VAR_ROAD_ID && type == TYPE_STRING) {
+            buf >> roadId;
+        }
+        else if (variableId == VAR_SPEED && type == TYPE_DOUBLE) {
+            buf >> speed;
+        }
+        else if (variableId == VAR_ANGLE && type == TYPE_DOUBLE) {
+            buf >> angle;
+        }
+        else {
+            skipTraCIValue(buf, type);
+        }
+    }
+
+    // same test as TraCIScenarioManager::processVehicleSubscription(), which deletes hosts outside the region of interest and creates none there
+    bool inRoi = !roi.hasConstraints() || roi.partOfRoads(roadId) || roi.onAnyRectangle(position);
+    if (managed) {
+        if (!inRoi) parkHostModule(objectId);
+        return;
+    }
+    if (!inRoi) return;
+
+    claimParkedModule(objectId, commandIfc->vehicle(objectId).getTypeId(), position, roadId, speed, angle);
+}
+
+void VeinsInetManagerBase::poolDepartedModules(const std::vector<std::string>& nodeIds)
+{
+    // requests are counted in preInitializeModule(), so nothing is lost by not asking while the pool is empty
+    if (nodeIds.empty() || poolSize == 0) return;
+
+    VeinsInetTraCIBatch batch(connection.get());
+    for (const auto& nodeId : nodeIds) {
+        batch.add(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_TYPE << nodeId);
+        batch.add(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_POSITION << nodeId);
+        batch.add(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_ROAD_ID << nodeId);
+        batch.add(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_SPEED << nodeId);
+        batch.add(CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << VAR_ANGLE << nodeId);
+    }
+
+    TraCIBuffer buf = batch.execute();
+    for (const auto& nodeId : nodeIds) {
+        std::string vType = VeinsInetTraCIBatch::readResult<std::string>(buf, CMD_GET_VEHICLE_VARIABLE, VAR_TYPE, nodeId, TYPE_STRING);
+        TraCICoord position;
+        position.x = VeinsInetTraCIBatch::readResult<double>(buf, CMD_GET_VEHICLE_VARIABLE, VAR_POSITION, nodeId, POSITION_2D);
+        buf >> position.y;
+        std::string roadId = VeinsInetTraCIBatch::readResult<std::string>(buf, CMD_GET_VEHICLE_VARIABLE, VAR_ROAD_ID, nodeId, TYPE_STRING);
+        double speed = VeinsInetTraCIBatch::readResult<double>(buf, CMD_GET_VEHICLE_VARIABLE, VAR_SPEED, nodeId, TYPE_DOUBLE);
+        double angle = VeinsInetTraCIBatch::readResult<double>(buf, CMD_GET_VEHICLE_VARIABLE, VAR_ANGLE, nodeId, TYPE_DOUBLE);
+
+        if (hosts.find(nodeId) != hosts.end()) continue;
+        bool inRoi = !roi.hasConstraints() || roi.partOfRoads(roadId) || roi.onAnyRectangle(position);
+        if (inRoi) claimParkedModule(nodeId, vType, position, roadId, speed, angle);
+    }
+    ASSERT(buf.eof());
+}
+
+void VeinsInetManagerBase::claimParkedModule(const std::string& nodeId, const std::string& vType, const TraCICoord& position, const std::string& roadId, double speed, double angle)
+{
+    std::string type = lookupTypeMapping(moduleTypes, vType);
+    if (type == "0") {
+        unequippedVehicles.insert(nodeId);
+        return;
+    }
+
+    cModule* mod = unparkModule(type, lookupTypeMapping(moduleNames, vType));
+    // without a parked host, TraCIScenarioManager creates a new one
+    if (!mod) return;
+    reuseHostModule(mod, nodeId, connection->traci2omnet(position), roadId, speed, connection->traci2omnetHeading(angle));
+}
+
+void VeinsInetManagerBase::setVehicleSpeed(const std::string& nodeId, double speed)
+{
+    queueVehicleCommand(nodeId, VAR_SPEED, TraCIBuffer() << static_cast<uint8_t>(TYPE_DOUBLE) << speed);
+}
+
+void VeinsInetManagerBase::changeVehicleRoute(const std::string& nodeId, const std::string& roadId, double travelTime)
+{
+    if (travelTime >= 0) {
+        queueVehicleCommand(nodeId, VAR_EDGE_TRAVELTIME, TraCIBuffer() << static_cast<uint8_t>(TYPE_COMPOUND) << static_cast<int32_t>(2) << static_cast<uint8_t>(TYPE_STRING) << roadId << static_cast<uint8_t>(TYPE_DOUBLE) << travelTime, roadId);
+    }
+    else {
+        queueVehicleCommand(nodeId, VAR_EDGE_TRAVELTIME, TraCIBuffer() << static_cast<uint8_t>(TYPE_COMPOUND) << static_cast<int32_t>(1) << static_cast<uint8_t>(TYPE_STRING) << roadId, roadId);
+    }
+    // superseding an earlier reroute moves it behind all travel time changes queued so far
+    queueVehicleCommand(nodeId, CMD_REROUTE_TRAVELTIME, TraCIBuffer() << static_cast<uint8_t>(TYPE_COMPOUND) << static_cast<int32_t>(0));
+}
+
+void VeinsInetManagerBase::queueVehicleCommand(const std::string& nodeId, uint8_t variableId, const TraCIBuffer& value, const std::string& key)
+{
+    auto inserted = vehicleCommandIndex.emplace(std::make_tuple(nodeId, variableId, key), vehicleCommands.size());
+    if (!inserted.second) {
+        // keep the order of the remaining commands: blank out the superseded one, append the new one
+        vehicleCommands[inserted.first->second].clear();
+        inserted.first->second = vehicleCommands.size();
+        vehicleCommandsMerged++;
+    }
+    vehicleCommands.push_back((TraCIBuffer() << variableId << nodeId).str() + value.str());
+}
+
+void VeinsInetManagerBase::flushVehicleCommands()
+{
+    if (vehicleCommands.empty()) return;
+
+    // without a TraCI connection (e.g., when replaying a trace), commands have no effect
+    if (!isConnected()) {
+        vehicleCommands.clear();
+        vehicleCommandIndex.clear();
+        return;
+    }
+
+    VeinsInetTraCIBatch batch(connection.get());
+    size_t numCommands = 0;
+    for (auto& command : vehicleCommands) {
+        if (command.empty()) continue;
+        batch.add(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer(command));
+        numCommands++;
+    }
+    TraCIBuffer buf = batch.execute();
+    for (size_t i = 0; i < numCommands; i++) {
+        VeinsInetTraCIBatch::readStatus(buf, CMD_SET_VEHICLE_VARIABLE);
+    }
+    ASSERT(buf.eof());
+
+    vehicleCommandsSent += numCommands;
+    vehicleCommands.clear();
+    vehicleCommandIndex.clear();
+}
+
+int VeinsInetManagerBase::getPartition(const inet::Coord& position) const
+{
+    return std::upper_bound(partitionBoundaries.begin(), partitionBoundaries.end(), position.x) - partitionBoundaries.begin();
+}
+
+void VeinsInetManagerBase::queueVehicleState(int partition, int kind, const VehicleHandle& handle)
+{
+    VeinsInetVehicleStateMessage*& msg = partitionStates[partition];
+    if (!msg) msg = new VeinsInetVehicleStateMessage("vehicleStates");
+
+    VeinsInetVehicleStateEntry entry;
+    entry.kind = kind;
+    entry.nodeId = handle.nodeId.c_str();
+    entry.roadId = VeinsInetRoadIdTable::getInstance().lookup(handle.state.road).c_str();
+    entry.x = handle.state.position.x;
+    entry.y = handle.state.position.y;
+    entry.z = handle.state.position.z;
+    entry.speed = handle.state.speed;
+    entry.angle = handle.state.angle;
+    msg->appendEntries(entry);
+}
+
+void VeinsInetManagerBase::shipVehicleStates()
+{
+    for (size_t i = 0; i < partitionStates.size(); i++) {
+        VeinsInetVehicleStateMessage* msg = partitionStates[i];
+        if (!msg) continue;
+        partitionStates[i] = nullptr;
+        shippedStates += msg->getEntriesArraySize();
+        send(msg, "partitionOut", i);
+    }
+}
+
+void VeinsInetManagerBase::processVehicleCommand(const VeinsInetVehicleCommandMessage* msg)
+{
+    forwardedCommands++;
+
+    // the vehicle may have left the simulation while the command was on its way
+    std::string nodeId = msg->getNodeId();
+    if (hosts.find(nodeId) == hosts.end()) {
+        EV_DEBUG << "Dropping command to vehicle " << nodeId << ", which left the simulation" << endl;
+        return;
+    }
+
+    switch (msg->getCommand()) {
+    case VEHICLE_COMMAND_SET_SPEED:
+        VeinsInetManagerBase::setVehicleSpeed(nodeId, msg->getValue());
+        break;
+    case VEHICLE_COMMAND_CHANGE_ROUTE:
+        VeinsInetManagerBase::changeVehicleRoute(nodeId, msg->getRoadId(), msg->getValue());
+        break;
+    default:
+        throw cRuntimeError("Unknown vehicle command %d", msg->getCommand());
+    }
+}
+
+void VeinsInetManagerBase::initializeAttachRegion()
+{
+    attachRegionInitialized = true;
+
+    attachRegion.addCircles(par("roiCircles").stdstringValue());
+    attachRegion.addPolygons(par("roiPolygons").stdstringValue());
+
+    double rsuRadius = par("roiRsuRadius");
+    if (rsuRadius > 0) {
+        const char* rsuName = par("roiRsuModules");
+        cModule* parentmod = getParentModule();
+        for (int i = 0; cModule* rsu = parentmod->getSubmodule(rsuName, i); i++) {
+            auto mobility = check_and_cast<inet::IMobility*>(rsu->getSubmodule("mobility"));
+            attachRegion.addCircle(mobility->getCurrentPosition(), rsuRadius);
+        }
+    }
+}
+
+void VeinsInetManagerBase::initializeSpatialIndex()
+{
+    spatialIndexInitialized = true;
+
+    double cellSize = par("spatialIndexCellSize");
+    if (cellSize <= 0) return;
+    spatialIndex.reset(new VeinsInetSpatialIndex(cellSize));
+
+    const char* rsuName = par("spatialIndexRsuModules");
+    cModule* parentmod = getParentModule();
+    for (int i = 0; cModule* rsu = parentmod->getSubmodule(rsuName, i); i++) {
+        auto mobility = check_and_cast<inet::IMobility*>(rsu->getSubmodule("mobility"));
+        spatialIndex->insert(rsu, mobility->getCurrentPosition());
+    }
+}
+
+void VeinsInetManagerBase::updateAttachment(cModule* mod, VehicleHandle& handle)
+{
+    if (attachRegion.empty()) return;
+
+    bool inside = attachRegion.contains(handle.state.position);
+    if (inside == handle.attached) return;
+
+    handle.attached = inside;
+    if (inside) {
+        stackAttaches++;
+        initiateLifecycleOperation(mod, new inet::ModuleStartOperation());
+    }
+    else {
+        stackDetaches++;
+        initiateLifecycleOperation(mod, new inet::ModuleStopOperation());
+    }
+}
+
+bool VeinsInetManagerBase::isAttached(const cModule* mod) const
+{
+    auto i = vehicleHandles.find(mod->getId());
+    return i == vehicleHandles.end() || i->second.attached;
+}
+
+bool VeinsInetManagerBase::initiateLifecycleOperation(cModule* mod, inet::LifecycleOperation* operation, inet::IDoneCallback* completionCallback)
+{
+    inet::LifecycleOperation::StringMap params;
+    operation->initialize(mod, params);
+    return lifecycleController.initiateOperation(operation, completionCallback);
+}
+
+void VeinsInetManagerBase::reuseHostModule(cModule* mod, const std::string& nodeId, const Coord& position, const std::string& roadId, double speed, Heading heading)
+{
+    poolHits++;
+
+    hosts[nodeId] = mod;
+    preInitializeModule(mod, nodeId, position, roadId, speed, heading, {VehicleSignal::undefined});
+    initiateLifecycleOperation(mod, new inet::ModuleStartOperation());
+
+    emit(traciModuleAddedSignal, mod);
+}
+
+void VeinsInetManagerBase::parkHostModule(const std::string& nodeId)
+{
+    cModule* mod = getManagedModule(nodeId);
+    ASSERT(mod);
+    bool attached = isAttached(mod);
+
+    emit(traciModuleRemovedSignal, mod);
+
+    hosts.erase(nodeId);
+    parkModule(mod, attached);
+}
+
+cModule* VeinsInetManagerBase::unparkModule(const std::string& type, const std::string& name)
+{
+    auto i = modulePool.find(std::make_pair(type, name));
+    if (i == modulePool.end() || i->second.empty()) return nullptr;
+
+    cModule* mod = i->second.back();
+    i->second.pop_back();
+    poolSize--;
+    return mod;
+}
+
+void VeinsInetManagerBase::parkModule(cModule* mod, bool attached)
+{
+    for (auto mm : getSubmodulesOfType<VeinsInetMobility>(mod)) {
+        mm->releaseVehicle();
+    }
+
+    if (!attached) {
+        moduleParked(mod);
+        return;
+    }
+
+    parkingModules.insert(mod);
+    auto callback = new ParkingCallback(this, mod);
+    if (initiateLifecycleOperation(mod, new inet::ModuleStopOperation(), callback)) {
+        // completed right away, callback will not be invoked
+        delete callback;
+        moduleParked(mod);
+    }
+}
+
+void VeinsInetManagerBase::moduleParked(cModule* mod)
+{
+    Enter_Method_Silent();
+
+    parkingModules.erase(mod);
+    modulePool[std::make_pair(std::string(mod->getNedTypeName()), std::string(mod->getName()))].push_back(mod);
+    poolSize++;
+    peakPoolSize = std::max(peakPoolSize, poolSize);
+}
+
+void VeinsInetManagerBase::clearModulePool()
+{
+    for (auto& entry : modulePool) {
+        for (auto mod : entry.second) {
+            mod->callFinish();
+            mod->deleteModule();
+        }
+    }
+    modulePool.clear();
+    poolSize = 0;
+    for (auto mod : parkingModules) {
+        mod->callFinish();
+        mod->deleteModule();
+    }
+    parkingModules.clear();
+}
+
+VeinsInetManagerBase::VehicleHandle& VeinsInetManagerBase::getVehicleHandle(cModule* mod)
+{
+    auto i = vehicleHandles.find(mod->getId());
+    if (i != vehicleHandles.end()) {
+        mobilityLookupsSaved++;
+        return i->second;
+    }
+
+    VehicleHandle& handle = vehicleHandles[mod->getId()];
+    handle.mobilityModules = getSubmodulesOfType<VeinsInetMobility>(mod);
+    return handle;
 }
 
 void VeinsInetManagerBase::preInitializeModule(cModule* mod, const std::string& nodeId, const Coord& position, const std::string& road_id, double speed, Heading heading, VehicleSignalSet signals)
 {
     TraCIScenarioManager::preInitializeModule(mod, nodeId, position, road_id, speed, heading, signals);
 
+    if (!attachRegionInitialized) initializeAttachRegion();
+    if (!spatialIndexInitialized) initializeSpatialIndex();
+
+    // every host, reused or newly built, was asked of the pool
+    if (poolModules) poolRequests++;
+
+    // subscribed at the end of the time step, together with all other new vehicles
+    if (batchedStateUpdates) pendingStateSubscriptions.push_back(nodeId);
+
+    // resolve mobility modules once, they are looked up in the handle table from now on
+    VehicleHandle& handle = vehicleHandles[mod->getId()];
+    handle.nodeId = nodeId;
+    handle.mobilityModules = getSubmodulesOfType<VeinsInetMobility>(mod);
+
+    VehicleState& state = handle.state;
+    state.position = inet::Coord(position.x, position.y);
+    state.speed = speed;
+    state.angle = heading.getRad();
+    state.road = VeinsInetRoadIdTable::getInstance().intern(road_id);
+    state.lastUpdate = simTime();
+
+    if (traceWriter) traceWriter->addCreate(nodeId, mod->getNedTypeName(), mod->getName(), mod->getDisplayString().str(), state.position, road_id, speed, state.angle);
+
+    handle.slot = vehicleStore.allocate(state.position, speed, state.angle, simTime());
+    if (spatialIndex) spatialIndex->insert(mod, state.position, state.road);
+
+    if (!partitionStates.empty()) {
+        handle.partition = getPartition(state.position);
+        queueVehicleState(handle.partition, VEHICLE_STATE_CREATE, handle);
+    }
+
     // pre-initialize VeinsInetMobility
-    auto mobilityModules = getSubmodulesOfType<VeinsInetMobility>(mod);
-    for (auto inetmm : mobilityModules) {
-        inetmm->preInitialize(nodeId, inet::Coord(position.x, position.y), road_id, speed, heading.getRad());
+    for (auto inetmm : handle.mobilityModules) {
+        inetmm->preInitialize(nodeId, inet::Coord(position.x, position.y), state.road, speed, heading.getRad());
+    }
+
+    // the bound a vehicle's speed never exceeds is that of its vType
+    if (queryMaxSpeed && isConnected() && !handle.mobilityModules.empty()) {
+        double maxSpeed = commandIfc->vehicle(nodeId).getMaxSpeed();
+        for (auto inetmm : handle.mobilityModules) {
+            inetmm->setMaxSpeed(maxSpeed);
+        }
     }
 }
 
@@ -68,9 +975,38 @@ void VeinsInetManagerBase::updateModulePosition(cModule* mod, const Coord& p, co
 {
     TraCIScenarioManager::updateModulePosition(mod, p, edge, speed, heading, signals);
 
-    // update position in VeinsInetMobility
-    auto mobilityModules = getSubmodulesOfType<VeinsInetMobility>(mod);
-    for (auto inetmm : mobilityModules) {
-        inetmm->nextPosition(inet::Coord(p.x, p.y), edge, speed, heading.getRad());
+    VehicleHandle& handle = getVehicleHandle(mod);
+
+    VehicleState& state = handle.state;
+    state.position = inet::Coord(p.x, p.y);
+    state.speed = speed;
+    state.angle = heading.getRad();
+    // vehicles mostly stay on their road, comparing is cheaper than interning
+    VeinsInetRoadIdTable& roadIds = VeinsInetRoadIdTable::getInstance();
+    if (edge != roadIds.lookup(state.road)) state.road = roadIds.intern(edge);
+    state.lastUpdate = simTime();
+
+    if (traceWriter) traceWriter->addUpdate(handle.nodeId, state.position, edge, speed, state.angle);
+
+    if (handle.partition >= 0) {
+        int partition = getPartition(state.position);
+        if (partition != handle.partition) {
+            // hand the vehicle over: the old partition removes its host, the new one creates one
+            queueVehicleState(handle.partition, VEHICLE_STATE_REMOVE, handle);
+            queueVehicleState(partition, VEHICLE_STATE_CREATE, handle);
+            handle.partition = partition;
+            partitionHandovers++;
+        }
+        else {
+            queueVehicleState(partition, VEHICLE_STATE_UPDATE, handle);
+        }
     }
+
+    // VeinsInetMobility is updated at the end of the time step, see updateVehicleKinematics()
+    ASSERT(handle.slot >= 0);
+    vehicleStore.update(handle.slot, state.position, speed, state.angle);
+    handle.moved = true;
+    if (spatialIndex) spatialIndex->move(mod, state.position, state.road);
+
+    updateAttachment(mod, handle);
 }
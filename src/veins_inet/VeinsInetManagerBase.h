@@ -22,23 +22,60 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
 #include "veins_inet/veins_inet.h"
 
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/modules/utility/SignalManager.h"
+#include "veins_inet/VeinsInetEventSchedule.h"
+#include "veins_inet/VeinsInetRegionOfInterest.h"
+#include "veins_inet/VeinsInetSpatialIndex.h"
+#include "veins_inet/VeinsInetVehicleCommandMessage_m.h"
+#include "veins_inet/VeinsInetVehicleStateMessage_m.h"
+#include "veins_inet/VeinsInetVehicleStore.h"
+#include "inet/common/geometry/common/Coord.h"
+#include "inet/common/lifecycle/LifecycleController.h"
 
 namespace veins {
 
+class VeinsInetMobility;
+class VeinsInetTraceWriter;
+
 /**
  * @brief
  * Creates and manages network nodes corresponding to cars.
  *
  * See the Veins website <a href="http://veins.car2x.org/"> for a tutorial, documentation, and publications </a>.
  *
+ * If poolModules is set, hosts of vehicles that leave the simulation are not deleted but shut down (via an INET ModuleStopOperation) and parked.
+ * A later vehicle of the same module type is then given a parked host, which is restarted (via an INET ModuleStartOperation)
+ * instead of building and initializing a new one. A reused host keeps its module index.
+ *
  * @author Christoph Sommer
  *
  */
 class VEINS_INET_API VeinsInetManagerBase : virtual public TraCIScenarioManager {
+public:
+    /**
+     * Last known state of a managed vehicle, as reported by the TraCI server
+     */
+    struct VehicleState {
+        inet::Coord position; /**< OMNeT++ position of front bumper */
+        double speed = -1; /**< speed in m/s */
+        double acceleration = 0; /**< acceleration in m/s^2 (as reported by the TraCI server if batchedStateUpdates is set, else derived from the last two speeds) */
+        double angle = 0; /**< heading in rad */
+        uint32_t road = 0; /**< index of the current road in VeinsInetRoadIdTable */
+        int32_t laneIndex = -1; /**< index of current lane (only kept up to date if batchedStateUpdates is set) */
+        simtime_t lastUpdate; /**< time this state was last updated */
+    };
+
 public:
     virtual ~VeinsInetManagerBase();
 
@@ -47,8 +84,303 @@ public:
     virtual void preInitializeModule(cModule* mod, const std::string& nodeId, const Coord& position, const std::string& road_id, double speed, Heading heading, VehicleSignalSet signals) override;
     virtual void updateModulePosition(cModule* mod, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals) override;
 
+    void finish() override;
+
+    void handleMessage(cMessage* msg) override;
+    void handleSelfMsg(cMessage* msg) override;
+
+    bool isBatchingStateUpdates() const
+    {
+        return batchedStateUpdates;
+    }
+
+    bool isPipelined() const
+    {
+        return pipelinedStepping;
+    }
+
+    bool isBatchingVehicleCommands() const
+    {
+        return batchedVehicleCommands;
+    }
+
+    /**
+     * Queues a change of a vehicle's speed (-1 to hand control back to SUMO).
+     * Queued commands are sent before the next time step is requested, so in pipelined mode they take effect one step later than usual.
+     * Only the last speed queued for a vehicle in a time step is sent.
+     */
+    virtual void setVehicleSpeed(const std::string& nodeId, double speed);
+
+    /**
+     * Queues setting the travel time of a road for a vehicle (-1 to reset it) and rerouting the vehicle, like TraCICommandInterface::Vehicle::changeRoute()
+     * Repeated changes of the same road of a vehicle in a time step are merged, and the vehicle is rerouted only once, after all of them.
+     */
+    virtual void changeVehicleRoute(const std::string& nodeId, const std::string& roadId, double travelTime);
+
+    /**
+     * Returns the cached state of a managed host, or nullptr if the host is not managed by this manager
+     */
+    const VehicleState* getVehicleState(const cModule* mod) const;
+
+    /**
+     * Returns the index of the positions of all vehicles and RSUs, or nullptr if spatialIndexCellSize is not set
+     */
+    VeinsInetSpatialIndex* getSpatialIndex()
+    {
+        if (!spatialIndexInitialized) initializeSpatialIndex();
+        return spatialIndex.get();
+    }
+
+    /**
+     * Returns the scripted incidents of all vehicles, as loaded from the eventSchedule parameter
+     */
+    const VeinsInetEventSchedule& getEventSchedule() const
+    {
+        return eventSchedule;
+    }
+
+protected:
+    /**
+     * Everything the manager needs to reach a managed host without searching its submodules
+     */
+    struct VehicleHandle {
+        std::string nodeId; /**< identifier used by TraCI server to refer to this node */
+        std::vector<VeinsInetMobility*> mobilityModules; /**< VeinsInetMobility submodules of this node */
+        VehicleState state; /**< cached vehicle state */
+        bool attached = true; /**< whether the network stack of this host is up (see attachRegion) */
+        int partition = -1; /**< index of the network partition the state of this vehicle is shipped to, -1 if states are not shipped */
+        int slot = -1; /**< slot of this vehicle in vehicleStore */
+        bool moved = false; /**< whether the vehicle was moved in the current time step, but its mobility modules were not updated yet */
+    };
+
+    /**
+     * Records the scalars of this manager, closes the trace being recorded, and deletes parked hosts.
+     * To be called by finish() of every subclass, before the finish() of the TraCIScenarioManager it derives from.
+     */
+    void finishRecording();
+
+    /**
+     * Returns the handle of a managed host, resolving (and caching) its mobility modules if it has none yet
+     */
+    VehicleHandle& getVehicleHandle(cModule* mod);
+
+    /**
+     * Derives velocities and orientations of all vehicles moved in the current time step in one batch, then updates their mobility modules
+     */
+    virtual void updateVehicleKinematics();
+
+    /**
+     * Subscribes the vehicles of all hosts created in this time step to the variables TraCIScenarioManager does not subscribe to (acceleration, lane), in one batched message.
+     * This is a subscription of its own, as TraCIScenarioManager rejects results holding variables it does not know;
+     * its results arrive with every time step and are consumed by processStateSubscription()
+     */
+    virtual void subscribeToVehicleStates();
+
+    /**
+     * Copies a result of a subscription made by subscribeToVehicleStates() (buf holds this single result) into the cached vehicle state.
+     * Returns false if the result belongs to another subscription
+     */
+    bool processStateSubscription(TraCIBuffer buf);
+
+    /**
+     * Processes the subscription results of a time step like TraCIScenarioManager::executeOneTimestep() does,
+     * but takes out those of subscribeToVehicleStates() and lets poolSubscribedModules() see all others first
+     */
+    void processStepResults(TraCIBuffer& buf);
+
+    /**
+     * Like TraCIScenarioManager::executeOneTimestep(), but only collects the result of the step requested one update interval ago
+     * and immediately requests the next one, so SUMO computes it while OMNeT++ processes the events in between
+     */
+    virtual void executePipelinedTimestep();
+
+    /**
+     * Like TraCIScenarioManager::executeOneTimestep(), but passes the subscription results to processStepResults()
+     */
+    virtual void executeSubscribedTimestep();
+
+    /**
+     * Looks at a subscription result before TraCIScenarioManager::processSubcriptionResult() does (buf is a copy of this single result):
+     * parks the hosts of vehicles that arrived, started teleporting, or left the region of interest,
+     * and hands a parked host to a new vehicle, so TraCIScenarioManager neither deletes nor creates one
+     */
+    void poolSubscribedModules(TraCIBuffer buf);
+
+    /**
+     * Hands parked hosts to vehicles that departed (or finished teleporting) in this time step.
+     * TraCIScenarioManager subscribes to these and creates their hosts right away, so their subscription results never pass poolSubscribedModules();
+     * their state is fetched in one batched query instead, and only if there is a parked host to give
+     */
+    void poolDepartedModules(const std::vector<std::string>& nodeIds);
+
+    /**
+     * Gives a parked host, if any, to a vehicle in the region of interest that has none, so TraCIScenarioManager does not create one
+     */
+    void claimParkedModule(const std::string& nodeId, const std::string& vType, const TraCICoord& position, const std::string& roadId, double speed, double angle);
+
+    /**
+     * Sends all queued vehicle commands to the TraCI server in one message
+     */
+    virtual void flushVehicleCommands();
+
+    /**
+     * Queues a CMD_SET_VEHICLE_VARIABLE command, value holding the type and value of the variable.
+     * A command queued earlier for the same vehicle, variable, and key (e.g., a road id) is dropped in favor of this one.
+     */
+    void queueVehicleCommand(const std::string& nodeId, uint8_t variableId, const TraCIBuffer& value, const std::string& key = "");
+
+    /**
+     * Returns the index of the network partition responsible for a position
+     */
+    int getPartition(const inet::Coord& position) const;
+
+    /**
+     * Adds the current state of a vehicle to the states to ship to a network partition at the end of the time step
+     */
+    void queueVehicleState(int partition, int kind, const VehicleHandle& handle);
+
+    /**
+     * Sends the states queued for each network partition
+     */
+    virtual void shipVehicleStates();
+
+    /**
+     * Executes a command that a network partition forwarded for one of its vehicles
+     */
+    virtual void processVehicleCommand(const VeinsInetVehicleCommandMessage* msg);
+
+    /**
+     * Sets up attachRegion from the roi* parameters, once positions of all RSUs are known
+     */
+    virtual void initializeAttachRegion();
+
+    /**
+     * Creates spatialIndex, if enabled, and adds all RSUs to it, once their positions are known
+     */
+    virtual void initializeSpatialIndex();
+
+    /**
+     * Starts or stops the network stack of a host as it enters or leaves attachRegion
+     */
+    virtual void updateAttachment(cModule* mod, VehicleHandle& handle);
+
+    /**
+     * Returns whether the network stack of a managed host is up
+     */
+    bool isAttached(const cModule* mod) const;
+
+    /**
+     * Runs an INET lifecycle operation on a host, returns true if it completed immediately
+     */
+    bool initiateLifecycleOperation(cModule* mod, inet::LifecycleOperation* operation, inet::IDoneCallback* completionCallback = nullptr);
+
+    /**
+     * Gives a parked host to a new vehicle and restarts its network stack, instead of creating a host like TraCIScenarioManager::addModule()
+     */
+    void reuseHostModule(cModule* mod, const std::string& nodeId, const Coord& position, const std::string& roadId, double speed, Heading heading);
+
+    /**
+     * Removes a host from the managed hosts and parks it in the pool, instead of deleting it like TraCIScenarioManager::deleteManagedModule()
+     */
+    void parkHostModule(const std::string& nodeId);
+
+    /**
+     * Returns a parked host of the given type and name (taking it out of the pool), or nullptr if there is none
+     */
+    cModule* unparkModule(const std::string& type, const std::string& name);
+
+    /**
+     * Stops the network stack of a host (unless it is already detached) and parks it in the pool once it is down
+     */
+    void parkModule(cModule* mod, bool attached);
+
+    /**
+     * Called when the network stack of a host that is to be parked is down
+     */
+    void moduleParked(cModule* mod);
+
+    /**
+     * Deletes all parked hosts and those still shutting down
+     */
+    void clearModulePool();
+
+protected:
+    class ParkingCallback : public inet::IDoneCallback {
+    public:
+        ParkingCallback(VeinsInetManagerBase* manager, cModule* mod)
+            : manager(manager)
+            , mod(mod)
+        {
+        }
+        void invoke() override
+        {
+            manager->moduleParked(mod);
+            delete this;
+        }
+
+    protected:
+        VeinsInetManagerBase* manager;
+        cModule* mod;
+    };
+
 protected:
     SignalManager signalManager;
+
+    std::map<int, VehicleHandle> vehicleHandles; /**< handle table of all managed hosts by module id (so they are iterated in the order they were created, not by address), filled in preInitializeModule() and pruned on module removal */
+    VeinsInetVehicleStore vehicleStore; /**< kinematic state of all managed vehicles */
+    uint64_t mobilityLookupsSaved = 0; /**< number of submodule searches avoided by the handle table */
+
+    bool queryMaxSpeed = false; /**< whether to ask the TraCI server for the maximum speed of new vehicles */
+    bool batchedStateUpdates = false; /**< whether to subscribe every vehicle with a host to the variables TraCIScenarioManager does not subscribe to */
+    std::vector<std::string> pendingStateSubscriptions; /**< vehicles of the hosts created in the current time step, to subscribe at its end */
+    uint64_t stateSubscriptions = 0; /**< number of state subscriptions sent */
+    uint64_t stateSubscriptionBatches = 0; /**< number of messages they were sent in */
+
+    bool batchedVehicleCommands = false; /**< whether applications queue all vehicle commands with the manager instead of sending them right away */
+    std::vector<std::string> vehicleCommands; /**< queued CMD_SET_VEHICLE_VARIABLE commands, in order; empty if superseded by a later one */
+    std::map<std::tuple<std::string, uint8_t, std::string>, size_t> vehicleCommandIndex; /**< position in vehicleCommands of the command queued last per vehicle, variable, and key */
+    uint64_t vehicleCommandsSent = 0; /**< number of vehicle commands sent */
+    uint64_t vehicleCommandsMerged = 0; /**< number of queued vehicle commands dropped because a later one superseded them */
+
+    bool pipelinedStepping = false; /**< whether to request the next time step from SUMO before processing the events of the current one */
+    bool stepPending = false; /**< whether a time step has been requested but its result has not been read yet */
+    simtime_t pendingStepTarget; /**< target time of the pending time step */
+    std::chrono::steady_clock::time_point stepRequestTime; /**< wall clock time the pending time step was requested */
+    double totalStepOverlap = 0; /**< wall clock time (s) SUMO had to compute time steps while OMNeT++ was processing events */
+    double totalStepWait = 0; /**< wall clock time (s) spent waiting for time step results nonetheless */
+    cOutVector stepOverlapVec; /**< vector plotting, per step, the wall clock time SUMO had to compute it while OMNeT++ was busy */
+    cOutVector stepWaitVec; /**< vector plotting, per step, the wall clock time spent waiting for its result */
+
+    std::vector<double> partitionBoundaries; /**< x coordinates separating the network partitions vehicle states are shipped to */
+    std::vector<VeinsInetVehicleStateMessage*> partitionStates; /**< per network partition, vehicle states to ship at the end of the current time step */
+    uint64_t shippedStates = 0; /**< number of vehicle states shipped to network partitions */
+    uint64_t partitionHandovers = 0; /**< number of times a vehicle moved from one network partition to another */
+    uint64_t forwardedCommands = 0; /**< number of vehicle commands received from network partitions */
+
+    VeinsInetRegionOfInterest attachRegion; /**< hosts have their network stack up only while inside this region (if it is not empty) */
+    bool attachRegionInitialized = false;
+    uint64_t stackAttaches = 0; /**< number of times a network stack was started on entering attachRegion */
+    uint64_t stackDetaches = 0; /**< number of times a network stack was stopped on leaving attachRegion */
+    inet::LifecycleController lifecycleController;
+
+    std::unique_ptr<VeinsInetSpatialIndex> spatialIndex; /**< positions of all vehicles and RSUs, if spatialIndexCellSize is set */
+    bool spatialIndexInitialized = false;
+
+    std::unique_ptr<VeinsInetTraceWriter> traceWriter; /**< records all vehicle events for VeinsInetTraceReplayManager, if traceRecordFile is set */
+
+    VeinsInetEventSchedule eventSchedule; /**< scripted incidents of vehicles, loaded once for all of their applications */
+
+    bool poolModules = false; /**< whether to park and reuse hosts instead of deleting and creating them */
+    std::map<std::string, std::string> moduleTypes; /**< module type by vehicle type ("*" for all others), parsed like TraCIScenarioManager does */
+    std::map<std::string, std::string> moduleNames; /**< module name by vehicle type ("*" for all others) */
+    std::set<std::string> unequippedVehicles; /**< vehicles whose type maps to no module, so their type is not asked for again */
+    std::map<std::pair<std::string, std::string>, std::vector<cModule*>> modulePool; /**< parked hosts, by NED type and module name */
+    std::set<cModule*> parkingModules; /**< hosts whose network stack is still shutting down */
+    size_t poolSize = 0; /**< number of parked hosts */
+    size_t peakPoolSize = 0; /**< largest number of parked hosts at any time */
+    uint64_t poolRequests = 0; /**< number of hosts requested from the pool (i.e., all hosts given to vehicles) */
+    uint64_t poolHits = 0; /**< number of hosts the pool could provide */
+    int minPoolHits = 0; /**< number of hosts that must have been reused by the end of the simulation, 0 to not check */
 };
 
 class VEINS_INET_API VeinsInetManagerBaseAccess {
@@ -59,4 +391,16 @@ public:
     };
 };
 
+class VEINS_INET_API VeinsInetSpatialIndexAccess {
+public:
+    /**
+     * Returns the spatial index of the manager, or nullptr if there is no manager or its spatialIndexCellSize is not set
+     */
+    VeinsInetSpatialIndex* get()
+    {
+        VeinsInetManagerBase* manager = VeinsInetManagerBaseAccess().get();
+        return manager ? manager->getSpatialIndex() : nullptr;
+    };
+};
+
 } // namespace veins
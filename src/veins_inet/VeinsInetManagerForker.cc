@@ -31,3 +31,9 @@ void VeinsInetManagerForker::initialize(int stage)
     TraCIScenarioManagerForker::initialize(stage);
     VeinsInetManagerBase::initialize(stage);
 }
+
+void VeinsInetManagerForker::finish()
+{
+    finishRecording();
+    TraCIScenarioManagerForker::finish();
+}
@@ -40,6 +40,7 @@ namespace veins {
  */
 class VEINS_INET_API VeinsInetManagerForker : public VeinsInetManagerBase, public TraCIScenarioManagerForker {
     virtual void initialize(int stage) override;
+    virtual void finish() override;
 };
 
 class VEINS_INET_API VeinsInetManagerForkerAccess {
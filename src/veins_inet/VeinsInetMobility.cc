@@ -27,6 +27,9 @@
 
 #include "veins_inet/VeinsInetMobility.h"
 
+#include <cmath>
+#include <cstring>
+
 #include "inet/common/INETMath.h"
 #include "inet/common/Units.h"
 #include "inet/common/geometry/common/GeographicCoordinateSystem.h"
@@ -41,6 +44,24 @@ Register_Class(VeinsInetMobility);
 //const simsignal_t TraCIMobility::collisionSignal = registerSignal("org_car2x_veins_modules_mobility_collision");
 namespace {
 const double MY_INFINITY = (std::numeric_limits<double>::has_infinity ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::max());
+
+/** returns the direction of travel for a given heading (0 is east, counter-clockwise, OMNeT++ y axis pointing down) */
+inet::Coord directionOf(double angle)
+{
+    return inet::Coord(cos(angle), -sin(angle));
+}
+
+/** wraps an angle difference to [-pi, pi) */
+double wrapAngle(double angle)
+{
+    return angle - 2 * M_PI * floor((angle + M_PI) / (2 * M_PI));
+}
+
+/** returns the rotation about the z axis for a given heading change (counter-clockwise, OMNeT++ y axis pointing down) */
+inet::Quaternion yawRotation(double angle)
+{
+    return inet::Quaternion(inet::EulerAngles(rad(-angle), rad(0.0), rad(0.0)));
+}
 }
 
 void VeinsInetMobility::Statistics::initialize()
@@ -53,6 +74,10 @@ void VeinsInetMobility::Statistics::initialize()
     maxSpeed = -MY_INFINITY;
     totalDistance = 0;
     totalCO2Emission = 0;
+    totalHaltingTime = 0;
+    deadReckoningSamples = 0;
+    totalDeadReckoningError = 0;
+    maxDeadReckoningError = 0;
 }
 
 void VeinsInetMobility::Statistics::watch(cSimpleModule&)
@@ -69,6 +94,11 @@ void VeinsInetMobility::Statistics::recordScalars(cSimpleModule& module)
     if (maxSpeed != -MY_INFINITY) module.recordScalar("maxSpeed", maxSpeed);
     module.recordScalar("totalDistance", totalDistance);
     module.recordScalar("totalCO2Emission", totalCO2Emission);
+    module.recordScalar("totalHaltingTime", totalHaltingTime);
+    if (deadReckoningSamples > 0) {
+        module.recordScalar("meanDeadReckoningError", totalDeadReckoningError / deadReckoningSamples, "m");
+        module.recordScalar("maxDeadReckoningError", maxDeadReckoningError, "m");
+    }
 }
 
 
@@ -84,13 +114,61 @@ VeinsInetMobility::~VeinsInetMobility()
     delete vehicleCommandInterface;
 }
 
-void VeinsInetMobility::preInitialize(std::string external_id, const inet::Coord& position, std::string road_id, double speed, double angle)
+void VeinsInetMobility::preInitialize(const std::string& external_id, const inet::Coord& position, uint32_t road, double speed, double angle)
 {
     Enter_Method_Silent();
     this->external_id = external_id;
+    snapshot.position = position;
+    snapshot.speed = speed;
+    snapshot.acceleration = 0;
+    snapshot.road = road;
+    snapshot.laneIndex = -1;
+    snapshot.time = simTime();
     lastPosition = position;
     lastVelocity = inet::Coord(cos(angle), -sin(angle)) * speed;
-    lastOrientation = inet::Quaternion(inet::EulerAngles(rad(-angle), rad(0.0), rad(0.0)));
+    lastOrientation = yawRotation(angle);
+
+    // nothing to derive rates from yet
+    lastAcceleration = inet::Coord::ZERO;
+    lastAngularVelocity = inet::Quaternion::IDENTITY;
+    lastAngularAcceleration = inet::Quaternion::IDENTITY;
+    reportedVelocity = lastVelocity;
+    reportedAngle = angle;
+    reportedYawRate = 0;
+    lastReport = simTime();
+    maxSpeed = par("maxSpeed").doubleValue();
+
+    // parameters are not read yet, so always start the first kinematic segment
+    segment.start = simTime();
+    segment.position = position;
+    segment.speed = std::max(speed, 0.0);
+    segment.angle = angle;
+    hasSegment = true;
+
+    if (isReleased) {
+        // host is reused for another vehicle, initialize() will not be called again
+        statistics.initialize();
+        lastUpdate = simTime();
+        last_speed = -1;
+        isReleased = false;
+        emitMobilityStateChangedSignal();
+    }
+}
+
+void VeinsInetMobility::releaseVehicle()
+{
+    Enter_Method_Silent();
+
+    statistics.stopTime = simTime();
+    statistics.recordScalars(*this);
+    finishVectorRecording();
+
+    external_id = "";
+    delete vehicleCommandInterface;
+    vehicleCommandInterface = nullptr;
+    hasSegment = false;
+    lastExtrapolation = -1;
+    isReleased = true;
 }
 
 void VeinsInetMobility::initialize(int stage)
@@ -103,32 +181,75 @@ void VeinsInetMobility::initialize(int stage)
     if (stage == 0){
     //currentPosXVec.setName("posx");
     //currentPosYVec.setName("posy");
-    currentSpeedVec.setName("speed");
-    currentAccelerationVec.setName("acceleration");
+    VeinsInetVectorRecorder::Config recorderConfig;
+    recorderConfig.recordEvery = par("vectorRecordEvery");
+    recorderConfig.changeThreshold = par("vectorChangeThreshold");
+    recorderConfig.summaryOnly = par("vectorSummaryOnly");
+    currentSpeedVec.configure(recorderConfig);
+    currentAccelerationVec.configure(recorderConfig);
     //currentCO2EmissionVec.setName("co2emission");
 
+    updateDisplayString = hasGUI();
+    interpolatePosition = par("interpolatePosition");
+    interpolationHorizon = par("interpolationHorizon").doubleValue();
+    if (interpolatePosition) deadReckoningErrorVec.setName("deadReckoningError");
+
     statistics.initialize();
     statistics.watch(*this);
     }
 }
 
-void VeinsInetMobility::nextPosition(const inet::Coord& position, std::string road_id, double speed, double angle)
+void VeinsInetMobility::nextPosition(const VeinsInetVehicleStore& store, size_t slot, uint32_t road, double acceleration, int32_t laneIndex)
 {
     Enter_Method_Silent();
+    snapshot.position = store.getPosition(slot);
+    snapshot.speed = store.getSpeed(slot);
+    snapshot.acceleration = acceleration;
+    snapshot.road = road;
+    snapshot.laneIndex = laneIndex;
+    snapshot.time = simTime();
+
+    applyVehicleState(store.getPosition(slot), store.getVelocity(slot), store.getOrientation(slot), store.getSpeed(slot), store.getAngle(slot));
+
+    // accumulated by the store for all vehicles at once
+    statistics.totalDistance = store.getDistance(slot);
+    statistics.totalCO2Emission = store.getCO2Emission(slot);
+    statistics.totalHaltingTime = store.getHaltingTime(slot);
+}
+
+void VeinsInetMobility::applyVehicleState(const inet::Coord& position, const inet::Coord& velocity, const inet::Quaternion& orientation, double speed, double angle)
+{
+    // derive rates from the last two TraCI updates
+    double dt = (simTime() - lastReport).dbl();
+    if (dt > 0) {
+        double yawRate = wrapAngle(angle - reportedAngle) / dt;
+        lastAcceleration = (velocity - reportedVelocity) / dt;
+        lastAngularVelocity = yawRotation(yawRate);
+        lastAngularAcceleration = yawRotation((yawRate - reportedYawRate) / dt);
+        reportedYawRate = yawRate;
+    }
+    reportedVelocity = velocity;
+    reportedAngle = angle;
+    lastReport = simTime();
+
+    updateKinematicSegment(position, speed, angle);
 
     lastPosition = position;
-    lastVelocity = inet::Coord(cos(angle), -sin(angle)) * speed;
-    lastOrientation = inet::Quaternion(inet::EulerAngles(rad(-angle), rad(0.0), rad(0.0)));
+    lastVelocity = velocity;
+    lastOrientation = orientation;
+    lastExtrapolation = simTime();
 
     changePosition(speed);
 
-    // Update display string to show node is getting updates
-    auto hostMod = getParentModule();
-    if (std::string(hostMod->getDisplayString().getTagArg("veins", 0)) == ". ") {
-        hostMod->getDisplayString().setTagArg("veins", 0, " .");
-    }
-    else {
-        hostMod->getDisplayString().setTagArg("veins", 0, ". ");
+    // Update display string to show node is getting updates (nobody would see it without a GUI)
+    if (updateDisplayString) {
+        auto hostMod = getParentModule();
+        if (strcmp(hostMod->getDisplayString().getTagArg("veins", 0), ". ") == 0) {
+            hostMod->getDisplayString().setTagArg("veins", 0, " .");
+        }
+        else {
+            hostMod->getDisplayString().setTagArg("veins", 0, ". ");
+        }
     }
 
     emitMobilityStateChangedSignal();
@@ -175,24 +296,95 @@ void VeinsInetMobility::changePosition(double speed)
     this->lastUpdate = simTime();
 }
 
+void VeinsInetMobility::updateKinematicSegment(const inet::Coord& position, double speed, double angle)
+{
+    if (!interpolatePosition) return;
+
+    simtime_t now = simTime();
+    speed = std::max(speed, 0.0);
+
+    if (hasSegment && now > segment.start) {
+        // keep statistics on how far off the extrapolated position was
+        double error = predictPosition(now).distance(position);
+        deadReckoningErrorVec.record(error);
+        statistics.deadReckoningSamples++;
+        statistics.totalDeadReckoningError += error;
+        statistics.maxDeadReckoningError = std::max(statistics.maxDeadReckoningError, error);
+
+        // estimate rates from the last two updates
+        double dt = (now - segment.start).dbl();
+        segment.acceleration = (speed - segment.speed) / dt;
+        segment.angularVelocity = wrapAngle(angle - segment.angle) / dt;
+    }
+
+    segment.start = now;
+    segment.position = position;
+    segment.speed = speed;
+    segment.angle = angle;
+    hasSegment = true;
+}
+
+double VeinsInetMobility::segmentTime(simtime_t t) const
+{
+    double dt = std::min(t - segment.start, interpolationHorizon).dbl();
+    if (dt <= 0) return 0;
+
+    // do not extrapolate backwards once a decelerating vehicle has come to a halt
+    if (segment.acceleration < 0 && segment.speed + segment.acceleration * dt < 0) dt = -segment.speed / segment.acceleration;
+
+    return dt;
+}
+
+inet::Coord VeinsInetMobility::predictPosition(simtime_t t) const
+{
+    double dt = segmentTime(t);
+    double distance = segment.speed * dt + 0.5 * segment.acceleration * dt * dt;
+    double turn = segment.angularVelocity * dt;
+
+    // travel along a circular arc: the chord points halfway through the turn and is shorter than the arc by sin(x)/x
+    double chordFactor = (std::abs(turn) < 1e-6) ? 1.0 : sin(turn / 2) / (turn / 2);
+    return segment.position + directionOf(segment.angle + turn / 2) * (distance * chordFactor);
+}
+
+void VeinsInetMobility::extrapolateKinematicSegment()
+{
+    if (!hasSegment) return;
+
+    simtime_t now = simTime();
+    if (now == lastExtrapolation) return;
+    lastExtrapolation = now;
+
+    double dt = segmentTime(now);
+    double speed = std::max(segment.speed + segment.acceleration * dt, 0.0);
+    if (!std::isnan(maxSpeed)) speed = std::min(speed, maxSpeed);
+    double angle = segment.angle + segment.angularVelocity * dt;
+
+    lastPosition = predictPosition(now);
+    lastVelocity = directionOf(angle) * speed;
+    lastOrientation = yawRotation(angle);
+}
+
 #if INET_VERSION >= 0x0403
 const inet::Coord& VeinsInetMobility::getCurrentPosition()
 {
+    if (interpolatePosition) extrapolateKinematicSegment();
     return lastPosition;
 }
 
 const inet::Coord& VeinsInetMobility::getCurrentVelocity()
 {
+    if (interpolatePosition) extrapolateKinematicSegment();
     return lastVelocity;
 }
 
 const inet::Coord& VeinsInetMobility::getCurrentAcceleration()
 {
-    throw cRuntimeError("Invalid operation");
+    return lastAcceleration;
 }
 
 const inet::Quaternion& VeinsInetMobility::getCurrentAngularPosition()
 {
+    if (interpolatePosition) extrapolateKinematicSegment();
     return lastOrientation;
 }
 
@@ -203,27 +395,30 @@ const inet::Quaternion& VeinsInetMobility::getCurrentAngularVelocity()
 
 const inet::Quaternion& VeinsInetMobility::getCurrentAngularAcceleration()
 {
-    throw cRuntimeError("Invalid operation");
+    return lastAngularAcceleration;
 }
 #else
 
 inet::Coord VeinsInetMobility::getCurrentPosition()
 {
+    if (interpolatePosition) extrapolateKinematicSegment();
     return lastPosition;
 }
 
 inet::Coord VeinsInetMobility::getCurrentVelocity()
 {
+    if (interpolatePosition) extrapolateKinematicSegment();
     return lastVelocity;
 }
 
 inet::Coord VeinsInetMobility::getCurrentAcceleration()
 {
-    throw cRuntimeError("Invalid operation");
+    return lastAcceleration;
 }
 
 inet::Quaternion VeinsInetMobility::getCurrentAngularPosition()
 {
+    if (interpolatePosition) extrapolateKinematicSegment();
     return lastOrientation;
 }
 
@@ -234,7 +429,7 @@ inet::Quaternion VeinsInetMobility::getCurrentAngularVelocity()
 
 inet::Quaternion VeinsInetMobility::getCurrentAngularAcceleration()
 {
-    throw cRuntimeError("Invalid operation");
+    return lastAngularAcceleration;
 }
 #endif
 void VeinsInetMobility::setInitialPosition()
@@ -246,9 +441,13 @@ void VeinsInetMobility::setInitialPosition()
 
 void VeinsInetMobility::finish()
 {
-    statistics.stopTime = simTime();
+    // statistics of a released host have already been recorded
+    if (!isReleased) {
+        statistics.stopTime = simTime();
 
-    statistics.recordScalars(*this);
+        statistics.recordScalars(*this);
+        finishVectorRecording();
+    }
 
     //cancelAndDelete(startAccidentMsg);
     //cancelAndDelete(stopAccidentMsg);
@@ -256,6 +455,24 @@ void VeinsInetMobility::finish()
     isPreInitialized = false;
 }
 
+void VeinsInetMobility::setMaxSpeed(double speed)
+{
+    Enter_Method_Silent();
+    maxSpeed = speed;
+}
+
+double VeinsInetMobility::calculateCO2emission(double v, double a) const
+{
+    return VeinsInetVehicleStore::co2Emission(v, a);
+}
+
+void VeinsInetMobility::finishVectorRecording()
+{
+    currentSpeedVec.finish();
+    currentAccelerationVec.finish();
+    recordScalar("vectorRecorderOverhead", currentSpeedVec.getOverhead() + currentAccelerationVec.getOverhead(), "s");
+}
+
 void VeinsInetMobility::handleSelfMessage(cMessage* message)
 {
 }
@@ -280,6 +497,8 @@ TraCICommandInterface* VeinsInetMobility::getCommandInterface() const
 
 TraCICommandInterface::Vehicle* VeinsInetMobility::getVehicleCommandInterface() const
 {
+    // managers without a TraCI connection (e.g., VeinsInetTraceReplayManager) have no command interface
+    if (!getCommandInterface()) return nullptr;
     if (!vehicleCommandInterface) vehicleCommandInterface = new TraCICommandInterface::Vehicle(getCommandInterface()->vehicle(getExternalId()));
     return vehicleCommandInterface;
 }
@@ -35,6 +35,10 @@ using namespace omnetpp;
 
 #include "veins_inet/veins_inet.h"
 
+#include "veins_inet/VeinsInetRoadIdTable.h"
+#include "veins_inet/VeinsInetVectorRecorder.h"
+#include "veins_inet/VeinsInetVehicleStore.h"
+
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
 
@@ -52,12 +56,28 @@ public:
         double maxSpeed; /**< for statistics: maximum value of currentSpeed */
         double totalDistance; /**< for statistics: total distance travelled */
         double totalCO2Emission; /**< for statistics: total CO2 emission */
+        simtime_t totalHaltingTime; /**< for statistics: total time spent slower than 0.1 m/s */
+        long deadReckoningSamples; /**< for statistics: number of TraCI updates compared against the extrapolated position */
+        double totalDeadReckoningError; /**< for statistics: sum of distances between extrapolated and reported position */
+        double maxDeadReckoningError; /**< for statistics: largest distance between extrapolated and reported position */
 
         void initialize();
         void watch(cSimpleModule& module);
         void recordScalars(cSimpleModule& module);
     };
 
+    /**
+     * @brief State of the vehicle as of the last TraCI update, for applications to read instead of querying TraCI.
+     */
+    struct VehicleSnapshot {
+        inet::Coord position; /**< position as reported, i.e., not extrapolated */
+        double speed = 0; /**< speed (m/s) */
+        double acceleration = 0; /**< acceleration (m/s^2), as reported by SUMO if the manager batches state updates, else derived from the last two speeds */
+        uint32_t road = 0; /**< index of the current road in VeinsInetRoadIdTable */
+        int32_t laneIndex = -1; /**< index of the current lane, -1 unless the manager batches state updates */
+        simtime_t time; /**< time of the TraCI update */
+    };
+
     //static const simsignal_t collisionSignal;
     //const static simsignal_t parkingStateChangedSignal;  //this is already handled in a different way
 
@@ -66,14 +86,17 @@ public:
     virtual ~VeinsInetMobility();
 
     /** @brief called by class VeinsInetManager */
-    virtual void preInitialize(std::string external_id, const inet::Coord& position, std::string road_id, double speed, double angle);
+    virtual void preInitialize(const std::string& external_id, const inet::Coord& position, uint32_t road, double speed, double angle);
 
     virtual void initialize(int stage) override;
 
     virtual void finish() override;
 
-    /** @brief called by class VeinsInetManager */
-    virtual void nextPosition(const inet::Coord& position, std::string road_id, double speed, double angle);
+    /** @brief called by class VeinsInetTraceReplayManager when the host is parked for reuse: records statistics and forgets the vehicle */
+    virtual void releaseVehicle();
+
+    /** @brief called by class VeinsInetManagerBase once per time step, with velocity and orientation already derived in its vehicle store */
+    virtual void nextPosition(const VeinsInetVehicleStore& store, size_t slot, uint32_t road, double acceleration, int32_t laneIndex);
 
     virtual void changePosition(double speed);
 
@@ -95,18 +118,74 @@ public:
     virtual inet::Quaternion getCurrentAngularAcceleration() override;
 #endif
 
+    /** @brief upper bound of the speed of this vehicle (m/s), NaN if unknown */
+    virtual double getMaxSpeed() const override
+    {
+        return maxSpeed;
+    }
+
+    /** @brief called by class VeinsInetManagerBase after preInitialize(), if it knows the maximum speed of the vehicle type */
+    virtual void setMaxSpeed(double speed);
+
     virtual std::string getExternalId() const;
+
+    /** @brief returns the index of the current road in VeinsInetRoadIdTable */
+    uint32_t getRoad() const
+    {
+        return snapshot.road;
+    }
+    const std::string& getRoadId() const
+    {
+        return VeinsInetRoadIdTable::getInstance().lookup(snapshot.road);
+    }
+    /** @brief returns the state of the vehicle as of the last TraCI update, all of it from the same time step */
+    const VehicleSnapshot& getVehicleSnapshot() const
+    {
+        return snapshot;
+    }
     virtual TraCIScenarioManager* getManager() const;
     virtual TraCICommandInterface* getCommandInterface() const;
+    /** @brief returns nullptr if the manager is not connected to a TraCI server */
     virtual TraCICommandInterface::Vehicle* getVehicleCommandInterface() const;
 
 protected:
     /** @brief The last velocity that was set by nextPosition(). */
     inet::Coord lastVelocity;
 
-    /** @brief The last angular velocity that was set by nextPosition(). */
+    /** @brief The last angular velocity (yaw rate per second) that was derived by nextPosition(). */
     inet::Quaternion lastAngularVelocity;
 
+    /** @brief The last acceleration that was derived by nextPosition(). */
+    inet::Coord lastAcceleration;
+
+    /** @brief The last angular acceleration that was derived by nextPosition(). */
+    inet::Quaternion lastAngularAcceleration;
+
+    simtime_t lastReport; /**< time of the last TraCI update (or preInitialize()) */
+    inet::Coord reportedVelocity; /**< velocity as of the last TraCI update, i.e., not extrapolated */
+    double reportedAngle = 0; /**< heading as of the last TraCI update (rad) */
+    double reportedYawRate = 0; /**< heading rate derived from the last two TraCI updates (rad/s) */
+    double maxSpeed = NAN; /**< upper bound of the speed of this vehicle (m/s), NaN if unknown */
+
+    /**
+     * @brief Kinematic segment set by nextPosition(), used to extrapolate the state of the vehicle up to the next TraCI update.
+     */
+    struct KinematicSegment {
+        simtime_t start; /**< time of the TraCI update that started this segment */
+        inet::Coord position; /**< position at start of segment */
+        double speed = 0; /**< speed at start of segment (m/s) */
+        double acceleration = 0; /**< estimated acceleration along heading (m/s^2) */
+        double angle = 0; /**< heading at start of segment (rad) */
+        double angularVelocity = 0; /**< estimated heading rate (rad/s) */
+    };
+
+    bool updateDisplayString = true; /**< whether to show TraCI updates in the display string of the host (only done under a GUI) */
+    bool interpolatePosition = false; /**< whether to extrapolate position, velocity, and orientation between TraCI updates */
+    simtime_t interpolationHorizon; /**< do not extrapolate further than this past the last TraCI update */
+    bool hasSegment = false; /**< true once segment has been set */
+    KinematicSegment segment;
+    simtime_t lastExtrapolation = -1; /**< time lastPosition, lastVelocity, and lastOrientation were extrapolated to */
+
     mutable TraCIScenarioManager* manager = nullptr; /**< cached value */
     mutable TraCICommandInterface* commandInterface = nullptr; /**< cached value */
     mutable TraCICommandInterface::Vehicle* vehicleCommandInterface = nullptr; /**< cached value */
@@ -120,20 +199,22 @@ protected:
 
     cOutVector currentPosXVec; /**< vector plotting posx */
     cOutVector currentPosYVec; /**< vector plotting posy */
-    cOutVector currentSpeedVec; /**< vector plotting speed */
-    cOutVector currentAccelerationVec; /**< vector plotting acceleration */
+    VeinsInetVectorRecorder currentSpeedVec{"speed"}; /**< vector plotting speed */
+    VeinsInetVectorRecorder currentAccelerationVec{"acceleration"}; /**< vector plotting acceleration */
     cOutVector currentCO2EmissionVec; /**< vector plotting current CO2 emission */
+    cOutVector deadReckoningErrorVec; /**< vector plotting distance between extrapolated and reported position */
 
     Statistics statistics; /**< everything statistics-related */
 
     bool isPreInitialized; /**< true if preInitialize() has been called immediately before initialize() */
+    bool isReleased = false; /**< true if releaseVehicle() has been called and preInitialize() has not been called since */
 
     double hostPositionOffset; /**< front offset for the antenna on this car */
     bool setHostSpeed; /**< whether to update the speed of the host (along with its position)  */
 
     simtime_t lastUpdate; /**< updated by nextPosition() */
     Coord roadPosition; /**< position of front bumper, updated by nextPosition() */
-    std::string road_id; /**< updated by nextPosition() */
+    VehicleSnapshot snapshot; /**< state of the vehicle as of the last TraCI update, updated by nextPosition() */
     Heading heading; /**< updated by nextPosition() */
     VehicleSignalSet signals; /**<updated by nextPosition() */
 
@@ -158,6 +239,36 @@ protected:
      */
     Coord calculateHostPosition(const Coord& vehiclePos) const;
 
+    /**
+     * Sets position, velocity, and orientation reported for the current time step and updates statistics
+     */
+    void applyVehicleState(const inet::Coord& position, const inet::Coord& velocity, const inet::Quaternion& orientation, double speed, double angle);
+
+    /**
+     * Flushes the speed and acceleration recorders and records their summaries and overhead
+     */
+    void finishVectorRecording();
+
+    /**
+     * Starts a new kinematic segment at the reported state, estimating acceleration and heading rate from the previous segment
+     */
+    void updateKinematicSegment(const inet::Coord& position, double speed, double angle);
+
+    /**
+     * Extrapolates lastPosition, lastVelocity, and lastOrientation along the current kinematic segment to the current simulation time
+     */
+    void extrapolateKinematicSegment();
+
+    /**
+     * Returns how far into the current kinematic segment to extrapolate for a given time, honoring interpolationHorizon and vehicles coming to a halt
+     */
+    double segmentTime(simtime_t t) const;
+
+    /**
+     * Returns the position the current kinematic segment predicts for a given time
+     */
+    inet::Coord predictPosition(simtime_t t) const;
+
 
 
 protected:
@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#include "veins_inet/VeinsInetMobilityBenchmark.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+
+using veins::VeinsInetMobility;
+using veins::VeinsInetMobilityBenchmark;
+
+Define_Module(veins::VeinsInetMobilityBenchmark);
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+VeinsInetMobilityBenchmark::~VeinsInetMobilityBenchmark()
+{
+    cancelAndDelete(stepTimer);
+}
+
+void VeinsInetMobilityBenchmark::initialize()
+{
+    if (hasGUI()) throw cRuntimeError("Run this benchmark under Cmdenv: under a GUI, VeinsInetMobility updates display strings itself");
+
+    stepLength = par("stepLength").doubleValue();
+    numSteps = par("numSteps");
+    stepTimer = new cMessage("step");
+    scheduleAt(simTime(), stepTimer);
+}
+
+void VeinsInetMobilityBenchmark::handleMessage(cMessage* msg)
+{
+    ASSERT(msg == stepTimer);
+
+    // hosts are created in one step and moved from the next one on, like the manager does
+    if (vehicles.empty()) {
+        createVehicles();
+    }
+    else {
+        step();
+        steps++;
+    }
+    if (steps < numSteps) scheduleAt(simTime() + stepLength, stepTimer);
+}
+
+void VeinsInetMobilityBenchmark::createVehicles()
+{
+    const char* vehicleType = par("vehicleType");
+    cModuleType* type = cModuleType::get(vehicleType);
+    int numVehicles = par("numVehicles");
+    double areaSize = par("areaSize");
+    double maxSpeed = par("maxSpeed");
+    cModule* parent = getParentModule();
+
+    for (int i = 0; i < numVehicles; i++) {
+        Vehicle vehicle;
+        vehicle.origin = inet::Coord(uniform(0, areaSize), uniform(0, areaSize));
+        vehicle.speed = uniform(0, maxSpeed);
+        vehicle.heading = uniform(-M_PI, M_PI);
+
+#if OMNETPP_BUILDNUM >= 1525
+        parent->setSubmoduleVectorSize("vehicle", i + 1);
+        vehicle.host = type->create("vehicle", parent, i);
+#else
+        vehicle.host = type->create("vehicle", parent, numVehicles, i);
+#endif
+        vehicle.host->finalizeParameters();
+        vehicle.host->buildInside();
+        vehicle.host->scheduleStart(simTime());
+        vehicle.mobility = check_and_cast<VeinsInetMobility*>(vehicle.host->getSubmodule("mobility"));
+
+        vehicle.slot = store.allocate(vehicle.origin, vehicle.speed, vehicle.heading, simTime());
+        vehicle.mobility->preInitialize(std::to_string(i), vehicle.origin, 0, vehicle.speed, vehicle.heading);
+        vehicle.host->callInitialize();
+        vehicles.push_back(vehicle);
+    }
+}
+
+inet::Coord VeinsInetMobilityBenchmark::getPosition(const Vehicle& vehicle) const
+{
+    // headings are counted counter-clockwise from east, with y pointing down
+    double distance = vehicle.speed * simTime().dbl();
+    return vehicle.origin + inet::Coord(std::cos(vehicle.heading), -std::sin(vehicle.heading)) * distance;
+}
+
+void VeinsInetMobilityBenchmark::step()
+{
+    // what the manager does on a TraCI update of all vehicles
+    for (auto& vehicle : vehicles) {
+        store.update(vehicle.slot, getPosition(vehicle), vehicle.speed, vehicle.heading);
+    }
+    auto start = Clock::now();
+    store.computeKinematics(simTime());
+    kinematicsTime += seconds(start);
+
+    start = Clock::now();
+    for (auto& vehicle : vehicles) {
+        vehicle.mobility->nextPosition(store, vehicle.slot, 0, store.getAcceleration(vehicle.slot), -1);
+    }
+    nextPositionTime += seconds(start);
+
+    // what nextPosition() did on top without a GUI before, for comparison
+    start = Clock::now();
+    for (auto& vehicle : vehicles) {
+        cDisplayString& displayString = vehicle.host->getDisplayString();
+        if (std::string(displayString.getTagArg("veins", 0)) == ". ") {
+            displayString.setTagArg("veins", 0, " .");
+        }
+        else {
+            displayString.setTagArg("veins", 0, ". ");
+        }
+    }
+    displayStringTime += seconds(start);
+
+    for (auto& vehicle : vehicles) {
+        if (vehicle.mobility->getCurrentPosition().distance(store.getPosition(vehicle.slot)) > 1e-6) throw cRuntimeError("Vehicle %s is not where the store has it", vehicle.host->getFullPath().c_str());
+    }
+}
+
+void VeinsInetMobilityBenchmark::finish()
+{
+    recordScalar("vehicles", vehicles.size());
+    recordScalar("steps", steps);
+    double updates = double(vehicles.size()) * steps;
+    if (updates == 0) return;
+
+    recordScalar("kinematicsTime", kinematicsTime / updates, "s");
+    recordScalar("nextPositionTime", nextPositionTime / updates, "s");
+    recordScalar("displayStringTime", displayStringTime / updates, "s");
+    recordScalar("displayStringShare", displayStringTime / (nextPositionTime + displayStringTime));
+    EV_INFO << "per vehicle and step of " << vehicles.size() << " vehicles: " << nextPositionTime / updates * 1e9 << " ns in nextPosition(), " << displayStringTime / updates * 1e9 << " ns more with display string updates" << endl;
+}
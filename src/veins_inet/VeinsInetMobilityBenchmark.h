@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#pragma once
+
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins_inet/VeinsInetMobility.h"
+#include "veins_inet/VeinsInetVehicleStore.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Times the per-step work of VeinsInetMobility for numVehicles vehicles, driven like VeinsInetManagerBase drives them, but without SUMO.
+ *
+ * Creates numVehicles hosts of vehicleType (which need a VeinsInetMobility submodule named mobility), moving straight at random headings and speeds.
+ * Every stepLength, it updates their slots in a VeinsInetVehicleStore, derives their kinematics, and calls nextPosition() of every mobility module.
+ * It then toggles the display string of every host the way nextPosition() did before skipping this without a GUI,
+ * so the scalars recorded by finish() show what that saves per vehicle and step.
+ * Meant to run under Cmdenv, as VeinsInetMobility updates display strings itself under a GUI.
+ */
+class VEINS_INET_API VeinsInetMobilityBenchmark : public cSimpleModule {
+public:
+    ~VeinsInetMobilityBenchmark() override;
+    void initialize() override;
+    void handleMessage(cMessage* msg) override;
+    void finish() override;
+
+protected:
+    struct Vehicle {
+        cModule* host;
+        VeinsInetMobility* mobility;
+        size_t slot;
+        inet::Coord origin; /**< position at time 0 */
+        double speed;
+        double heading;
+    };
+
+    void createVehicles();
+    void step();
+    inet::Coord getPosition(const Vehicle& vehicle) const;
+
+protected:
+    cMessage* stepTimer = nullptr;
+    simtime_t stepLength;
+    int numSteps;
+    int steps = 0; /**< number of steps taken after creating the vehicles */
+    std::vector<Vehicle> vehicles;
+    VeinsInetVehicleStore store;
+
+    double kinematicsTime = 0; /**< wall clock time (s) spent deriving kinematics in the store */
+    double nextPositionTime = 0; /**< wall clock time (s) spent in nextPosition() */
+    double displayStringTime = 0; /**< wall clock time (s) spent toggling display strings like nextPosition() used to */
+};
+
+} // namespace veins
@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetObjectPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+using veins::VeinsInetObjectPool;
+
+VeinsInetObjectPool::VeinsInetObjectPool(size_t blockSize, size_t blocksPerArena)
+    : blockSize(std::max(blockSize, sizeof(FreeBlock)))
+    , blocksPerArena(blocksPerArena)
+{
+    // keep every block aligned like memory from the global operator new
+    const size_t alignment = alignof(std::max_align_t);
+    this->blockSize = (this->blockSize + alignment - 1) / alignment * alignment;
+    ASSERT(blocksPerArena > 0);
+}
+
+void VeinsInetObjectPool::addArena()
+{
+    arenaNext = static_cast<char*>(::operator new(blockSize * blocksPerArena));
+    arenaEnd = arenaNext + blockSize * blocksPerArena;
+    arenas.push_back(arenaNext);
+}
+
+void* VeinsInetObjectPool::allocate(size_t size)
+{
+    if (size > blockSize) return ::operator new(size);
+
+    allocations++;
+    inUse++;
+    peakInUse = std::max(peakInUse, inUse);
+
+    if (freeList) {
+        reuses++;
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        return block;
+    }
+
+    if (arenaNext == arenaEnd) addArena();
+    void* block = arenaNext;
+    arenaNext += blockSize;
+    return block;
+}
+
+void VeinsInetObjectPool::deallocate(void* p, size_t size)
+{
+    if (!p) return;
+    if (size > blockSize) {
+        ::operator delete(p);
+        return;
+    }
+
+    ASSERT(inUse > 0);
+    inUse--;
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = freeList;
+    freeList = block;
+}
@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Free list of fixed-size memory blocks carved from large arenas, for the class-specific operator new and delete of short-lived objects (e.g., payload chunks).
+ *
+ * Blocks are never returned to the system, so an object may outlive any module using the pool.
+ * Requests larger than the block size (e.g., for subclasses) are passed on to the global operator new.
+ */
+class VEINS_INET_API VeinsInetObjectPool {
+public:
+    VeinsInetObjectPool(size_t blockSize, size_t blocksPerArena = 256);
+    VeinsInetObjectPool(const VeinsInetObjectPool&) = delete;
+    VeinsInetObjectPool& operator=(const VeinsInetObjectPool&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+
+    /** @brief number of allocations served, from the free list or not */
+    uint64_t getAllocations() const
+    {
+        return allocations;
+    }
+    /** @brief number of allocations served by reusing a block freed before */
+    uint64_t getReuses() const
+    {
+        return reuses;
+    }
+    size_t getArenas() const
+    {
+        return arenas.size();
+    }
+    size_t getInUse() const
+    {
+        return inUse;
+    }
+    size_t getPeakInUse() const
+    {
+        return peakInUse;
+    }
+
+protected:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void addArena();
+
+protected:
+    size_t blockSize;
+    size_t blocksPerArena;
+    std::vector<char*> arenas;
+    FreeBlock* freeList = nullptr;
+    char* arenaNext = nullptr; /**< next block of the newest arena never handed out */
+    char* arenaEnd = nullptr;
+
+    uint64_t allocations = 0;
+    uint64_t reuses = 0;
+    size_t inUse = 0;
+    size_t peakInUse = 0;
+};
+
+} // namespace veins
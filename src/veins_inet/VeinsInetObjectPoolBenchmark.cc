@@ -0,0 +1,88 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#include "veins_inet/VeinsInetObjectPoolBenchmark.h"
+
+#include <chrono>
+#include <vector>
+
+#include "veins_inet/VeinsInetSampleApplication.h"
+
+using namespace inet;
+using veins::VeinsInetObjectPoolBenchmark;
+
+Define_Module(veins::VeinsInetObjectPoolBenchmark);
+
+void VeinsInetObjectPoolBenchmark::initialize()
+{
+    numPayloads = par("numPayloads");
+    livePayloads = par("livePayloads").intValue();
+    if (livePayloads < 1) throw cRuntimeError("livePayloads must be at least 1");
+
+    auto& pool = VeinsInetPooledSampleMessage::getPool();
+    size_t inUse = pool.getInUse();
+    uint64_t allocations = pool.getAllocations();
+
+    // alternate, so neither kind always runs on a warmer cache or heap
+    int numRounds = par("numRounds");
+    for (int round = 0; round < numRounds; round++) {
+        pooledTime += run<VeinsInetPooledSampleMessage>();
+        globalTime += run<VeinsInetSampleMessage>();
+        payloads += numPayloads;
+    }
+
+    if (pool.getAllocations() - allocations != payloads) throw cRuntimeError("Only %lu of %lu pooled payloads came from the pool", static_cast<unsigned long>(pool.getAllocations() - allocations), static_cast<unsigned long>(payloads));
+    if (pool.getInUse() != inUse) throw cRuntimeError("Pool has %zu blocks in use after all payloads were dropped, not %zu", pool.getInUse(), inUse);
+}
+
+template <typename T>
+double VeinsInetObjectPoolBenchmark::run()
+{
+    std::vector<Ptr<T>> inFlight(livePayloads);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numPayloads; i++) {
+        // the oldest payload is dropped to make room, check it was not overwritten while in flight
+        auto& slot = inFlight[i % livePayloads];
+        if (slot && slot->getSequenceNumber() != static_cast<uint32_t>(i - livePayloads)) throw cRuntimeError("Payload %d came back as %u", static_cast<int>(i - livePayloads), slot->getSequenceNumber());
+        slot = makeShared<T>();
+        slot->setSequenceNumber(i);
+    }
+    inFlight.clear();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void VeinsInetObjectPoolBenchmark::finish()
+{
+    auto& pool = VeinsInetPooledSampleMessage::getPool();
+    recordScalar("payloads", payloads);
+    recordScalar("livePayloads", livePayloads);
+    recordScalar("poolArenas", pool.getArenas());
+    recordScalar("poolPeakInUse", pool.getPeakInUse());
+    if (payloads == 0) return;
+
+    recordScalar("pooledTime", pooledTime / payloads, "s");
+    recordScalar("globalTime", globalTime / payloads, "s");
+    if (pooledTime > 0) recordScalar("poolSpeedup", globalTime / pooledTime);
+    EV_INFO << "payloads with " << livePayloads << " in flight: " << pooledTime / payloads * 1e9 << " ns (pool) vs. " << globalTime / payloads * 1e9 << " ns (global operator new)" << endl;
+}
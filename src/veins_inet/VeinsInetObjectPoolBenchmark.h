@@ -0,0 +1,60 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "veins_inet/veins_inet.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Compares allocating VeinsInetPooledSampleMessage payloads from their pool with allocating plain VeinsInetSampleMessage payloads by the global operator new.
+ *
+ * Both kinds are created and dropped in the same pattern, numPayloads per round for numRounds rounds, with livePayloads in flight at any time
+ * (like payloads queued in MACs or waiting to be forwarded).
+ * Payloads that do not come back intact, or blocks the pool does not get back, are an error.
+ * Time per payload of both is recorded as scalars by finish().
+ */
+class VEINS_INET_API VeinsInetObjectPoolBenchmark : public cSimpleModule {
+public:
+    void initialize() override;
+    void finish() override;
+
+protected:
+    /** @brief creates, holds, and drops numPayloads payloads of type T, returning the wall clock time (s) taken */
+    template <typename T>
+    double run();
+
+protected:
+    int numPayloads;
+    size_t livePayloads;
+    uint64_t payloads = 0; /**< number of payloads of each kind */
+    double pooledTime = 0; /**< wall clock time (s) spent on pooled payloads */
+    double globalTime = 0; /**< wall clock time (s) spent on payloads from the global operator new */
+};
+
+} // namespace veins
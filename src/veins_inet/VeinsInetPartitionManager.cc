@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetPartitionManager.h"
+
+#include "veins/base/utils/Coord.h"
+
+using veins::VeinsInetPartitionManager;
+
+Define_Module(veins::VeinsInetPartitionManager);
+
+void VeinsInetPartitionManager::initialize(int stage)
+{
+    VeinsInetPassiveManagerBase::initialize(stage);
+    if (stage != 1) return;
+
+    updateInterval = par("updateInterval").doubleValue();
+    hostType = par("hostType").stdstringValue();
+    hostName = par("hostName").stdstringValue();
+    hostDisplayString = par("hostDisplayString").stdstringValue();
+
+    // a vehicle gets a different host index in every partition, and a new one on every handover
+    if (getEventSchedule().hasIndexedEvents()) throw cRuntimeError("Events of partitioned vehicles must select them by SUMO id (vehicle), not by host index");
+}
+
+void VeinsInetPartitionManager::finish()
+{
+    VeinsInetPassiveManagerBase::finish();
+
+    recordScalar("receivedStates", receivedStates);
+    recordScalar("sentCommands", sentCommands);
+}
+
+void VeinsInetPartitionManager::handleMessage(cMessage* msg)
+{
+    if (auto states = dynamic_cast<VeinsInetVehicleStateMessage*>(msg)) {
+        processVehicleStates(states);
+        delete msg;
+        return;
+    }
+    VeinsInetPassiveManagerBase::handleMessage(msg);
+}
+
+void VeinsInetPartitionManager::processVehicleStates(const VeinsInetVehicleStateMessage* msg)
+{
+    simtime_t now = simTime();
+    emit(traciTimestepBeginSignal, now);
+
+    for (size_t i = 0; i < msg->getEntriesArraySize(); i++) {
+        const VeinsInetVehicleStateEntry& entry = msg->getEntries(i);
+        Coord position(entry.x, entry.y, entry.z);
+        switch (entry.kind) {
+        case VEHICLE_STATE_CREATE:
+            addHostModule(entry.nodeId.c_str(), hostType, hostName, hostDisplayString, position, entry.roadId.c_str(), entry.speed, Heading(entry.angle));
+            break;
+        case VEHICLE_STATE_UPDATE:
+            moveHostModule(entry.nodeId.c_str(), position, entry.roadId.c_str(), entry.speed, Heading(entry.angle));
+            break;
+        case VEHICLE_STATE_REMOVE:
+            removeHostModule(entry.nodeId.c_str());
+            break;
+        default:
+            throw cRuntimeError("Vehicle state of \"%s\" has unknown kind %d", entry.nodeId.c_str(), entry.kind);
+        }
+    }
+    receivedStates += msg->getEntriesArraySize();
+
+    emit(traciTimestepEndSignal, now);
+}
+
+void VeinsInetPartitionManager::setVehicleSpeed(const std::string& nodeId, double speed)
+{
+    Enter_Method_Silent();
+
+    auto msg = new VeinsInetVehicleCommandMessage("setVehicleSpeed");
+    msg->setCommand(VEHICLE_COMMAND_SET_SPEED);
+    msg->setNodeId(nodeId.c_str());
+    msg->setValue(speed);
+    sendVehicleCommand(msg);
+}
+
+void VeinsInetPartitionManager::changeVehicleRoute(const std::string& nodeId, const std::string& roadId, double travelTime)
+{
+    Enter_Method_Silent();
+
+    auto msg = new VeinsInetVehicleCommandMessage("changeVehicleRoute");
+    msg->setCommand(VEHICLE_COMMAND_CHANGE_ROUTE);
+    msg->setNodeId(nodeId.c_str());
+    msg->setRoadId(roadId.c_str());
+    msg->setValue(travelTime);
+    sendVehicleCommand(msg);
+}
+
+void VeinsInetPartitionManager::sendVehicleCommand(VeinsInetVehicleCommandMessage* msg)
+{
+    sentCommands++;
+    send(msg, "commandOut");
+}
@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <string>
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins_inet/VeinsInetPassiveManagerBase.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Creates, moves, and removes the network nodes of one partition of a parallel simulation,
+ * as told by the manager running SUMO in another partition.
+ *
+ * The manager running SUMO (VeinsInetManager or VeinsInetManagerForker with its partitionOut gates connected)
+ * ships the states of all vehicles within the stripe of the playground covered by this partition once per time step.
+ * Vehicles leaving the stripe are removed here and created in the partition they move to.
+ *
+ * Commands to vehicles (see VeinsInetManagerBase::setVehicleSpeed()) are forwarded to the manager running SUMO,
+ * so they take effect one link delay (at least) later than in a sequential simulation.
+ *
+ */
+class VEINS_INET_API VeinsInetPartitionManager : public VeinsInetPassiveManagerBase {
+public:
+    void initialize(int stage) override;
+    void finish() override;
+
+    void setVehicleSpeed(const std::string& nodeId, double speed) override;
+    void changeVehicleRoute(const std::string& nodeId, const std::string& roadId, double travelTime) override;
+
+protected:
+    void handleMessage(cMessage* msg) override;
+
+    /**
+     * Creates, moves, and removes hosts as told by the manager running SUMO, as one time step
+     */
+    virtual void processVehicleStates(const VeinsInetVehicleStateMessage* msg);
+
+    /**
+     * Forwards a command to the manager running SUMO
+     */
+    virtual void sendVehicleCommand(VeinsInetVehicleCommandMessage* msg);
+
+protected:
+    std::string hostType; /**< NED type of hosts to create */
+    std::string hostName; /**< name of the module vector of hosts to create */
+    std::string hostDisplayString; /**< display string of hosts to create */
+
+    uint64_t receivedStates = 0; /**< number of vehicle states received */
+    uint64_t sentCommands = 0; /**< number of vehicle commands forwarded */
+};
+
+} // namespace veins
@@ -0,0 +1,114 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetPassiveManagerBase.h"
+
+#include "veins/base/utils/Coord.h"
+
+using veins::VeinsInetPassiveManagerBase;
+
+Define_Module(veins::VeinsInetPassiveManagerBase);
+
+void VeinsInetPassiveManagerBase::initialize(int stage)
+{
+    // do not call TraCIScenarioManager::initialize(), there is no TraCI server to connect to
+    VeinsInetManagerBase::initialize(stage);
+}
+
+void VeinsInetPassiveManagerBase::finish()
+{
+    finishRecording();
+
+    while (!hosts.empty()) {
+        cModule* mod = hosts.begin()->second;
+        emit(traciModuleRemovedSignal, mod);
+        hosts.erase(hosts.begin());
+        mod->callFinish();
+        mod->deleteModule();
+    }
+
+    // all hosts are gone by now, this only records the scalars of the base class
+    TraCIScenarioManager::finish();
+}
+
+cModule* VeinsInetPassiveManagerBase::addHostModule(const std::string& nodeId, const std::string& type, const std::string& name, const std::string& displayString, const Coord& position, const std::string& roadId, double speed, Heading heading)
+{
+    if (hosts.find(nodeId) != hosts.end()) throw cRuntimeError("tried adding duplicate module \"%s\"", nodeId.c_str());
+
+    if (poolModules) {
+        poolRequests++;
+        if (cModule* mod = unparkModule(type, name)) {
+            reuseHostModule(mod, nodeId, position, roadId, speed, heading);
+            return mod;
+        }
+    }
+
+    cModuleType* nodeType = cModuleType::get(type.c_str());
+    if (!nodeType) throw cRuntimeError("Module Type \"%s\" not found", type.c_str());
+
+    cModule* parentmod = getParentModule();
+    int32_t nodeVectorIndex = nextVectorIndex++;
+#if OMNETPP_BUILDNUM >= 1525
+    parentmod->setSubmoduleVectorSize(name.c_str(), nodeVectorIndex + 1);
+    cModule* mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex);
+#else
+    cModule* mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex, nodeVectorIndex);
+#endif
+    mod->finalizeParameters();
+    if (hasGUI()) mod->getDisplayString().parse(displayString.c_str());
+    mod->buildInside();
+    mod->scheduleStart(simTime() + updateInterval);
+
+    preInitializeModule(mod, nodeId, position, roadId, speed, heading, {VehicleSignal::undefined});
+
+    emit(traciModulePreInitSignal, mod);
+
+    mod->callInitialize();
+    hosts[nodeId] = mod;
+
+    emit(traciModuleAddedSignal, mod);
+    return mod;
+}
+
+void VeinsInetPassiveManagerBase::moveHostModule(const std::string& nodeId, const Coord& position, const std::string& roadId, double speed, Heading heading)
+{
+    cModule* mod = getManagedModule(nodeId);
+    if (!mod) throw cRuntimeError("no vehicle with Id \"%s\" found", nodeId.c_str());
+    updateModulePosition(mod, position, roadId, speed, heading, {VehicleSignal::undefined});
+}
+
+void VeinsInetPassiveManagerBase::removeHostModule(const std::string& nodeId)
+{
+    cModule* mod = getManagedModule(nodeId);
+    if (!mod) throw cRuntimeError("no vehicle with Id \"%s\" found", nodeId.c_str());
+    if (poolModules) {
+        parkHostModule(nodeId);
+        return;
+    }
+
+    emit(traciModuleRemovedSignal, mod);
+
+    hosts.erase(nodeId);
+    mod->callFinish();
+    mod->deleteModule();
+}
@@ -0,0 +1,67 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <string>
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins_inet/VeinsInetManagerBase.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Base class of managers that do not connect to a TraCI server themselves, but are told about vehicles from elsewhere
+ * (e.g., a trace file or the partition that runs SUMO), and create, move, and remove network nodes accordingly.
+ *
+ * Hosts are pooled like in VeinsInetManagerBase, if poolModules is set.
+ *
+ */
+class VEINS_INET_API VeinsInetPassiveManagerBase : public VeinsInetManagerBase {
+public:
+    void initialize(int stage) override;
+    void finish() override;
+
+protected:
+    /**
+     * Creates and pre-initializes a host module (or takes one from the pool), following TraCIScenarioManager::addModule()
+     */
+    virtual cModule* addHostModule(const std::string& nodeId, const std::string& type, const std::string& name, const std::string& displayString, const Coord& position, const std::string& roadId, double speed, Heading heading);
+
+    /**
+     * Moves a host module, like TraCIScenarioManager::processVehicleSubscription() does for every vehicle in every time step
+     */
+    virtual void moveHostModule(const std::string& nodeId, const Coord& position, const std::string& roadId, double speed, Heading heading);
+
+    /**
+     * Removes a host module (or parks it in the pool), following TraCIScenarioManager::deleteManagedModule()
+     */
+    virtual void removeHostModule(const std::string& nodeId);
+
+protected:
+    int nextVectorIndex = 0; /**< next OMNeT++ module vector index to use */
+};
+
+} // namespace veins
@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins_inet/VeinsInetRegionOfInterest.h"
+
+using veins::VeinsInetRegionOfInterest;
+
+namespace {
+
+inet::Coord parsePoint(const std::string& s, const std::string& what)
+{
+    std::vector<double> v = cStringTokenizer(s.c_str(), ",").asDoubleVector();
+    if (v.size() != 2) throw cRuntimeError("Invalid point \"%s\" in %s, expected \"x,y\"", s.c_str(), what.c_str());
+    return inet::Coord(v[0], v[1]);
+}
+
+} // namespace
+
+void VeinsInetRegionOfInterest::addCircles(const std::string& circles)
+{
+    for (auto& s : cStringTokenizer(circles.c_str(), " ").asVector()) {
+        std::vector<double> v = cStringTokenizer(s.c_str(), ",").asDoubleVector();
+        if (v.size() != 3) throw cRuntimeError("Invalid circle \"%s\" in region of interest, expected \"x,y,r\"", s.c_str());
+        addCircle(inet::Coord(v[0], v[1]), v[2]);
+    }
+}
+
+void VeinsInetRegionOfInterest::addPolygons(const std::string& polygons)
+{
+    for (auto& p : cStringTokenizer(polygons.c_str(), ";").asVector()) {
+        std::vector<inet::Coord> points;
+        for (auto& s : cStringTokenizer(p.c_str(), " ").asVector()) {
+            points.push_back(parsePoint(s, "region of interest"));
+        }
+        if (points.empty()) continue;
+        addPolygon(points);
+    }
+}
+
+void VeinsInetRegionOfInterest::addCircle(const inet::Coord& center, double radius)
+{
+    if (radius <= 0) throw cRuntimeError("Circle in region of interest must have a positive radius");
+    circles.push_back({inet::Coord(center.x, center.y), radius});
+}
+
+void VeinsInetRegionOfInterest::addPolygon(const std::vector<inet::Coord>& points)
+{
+    if (points.size() < 3) throw cRuntimeError("Polygon in region of interest must have at least 3 points");
+
+    Polygon polygon;
+    polygon.min = polygon.max = inet::Coord(points[0].x, points[0].y);
+    for (auto& point : points) {
+        polygon.points.push_back(inet::Coord(point.x, point.y));
+        polygon.min.x = std::min(polygon.min.x, point.x);
+        polygon.min.y = std::min(polygon.min.y, point.y);
+        polygon.max.x = std::max(polygon.max.x, point.x);
+        polygon.max.y = std::max(polygon.max.y, point.y);
+    }
+    polygons.push_back(polygon);
+}
+
+bool VeinsInetRegionOfInterest::contains(const inet::Coord& position) const
+{
+    for (auto& circle : circles) {
+        double dx = position.x - circle.center.x;
+        double dy = position.y - circle.center.y;
+        if (dx * dx + dy * dy <= circle.radius * circle.radius) return true;
+    }
+
+    for (auto& polygon : polygons) {
+        if (position.x < polygon.min.x || position.x > polygon.max.x || position.y < polygon.min.y || position.y > polygon.max.y) continue;
+
+        // even-odd rule: count crossings of a ray from position towards +x
+        bool inside = false;
+        const auto& p = polygon.points;
+        for (size_t i = 0, j = p.size() - 1; i < p.size(); j = i++) {
+            if ((p[i].y > position.y) != (p[j].y > position.y) && position.x < (p[j].x - p[i].x) * (position.y - p[i].y) / (p[j].y - p[i].y) + p[i].x) inside = !inside;
+        }
+        if (inside) return true;
+    }
+
+    return false;
+}
+
+std::vector<std::pair<inet::Coord, inet::Coord>> VeinsInetRegionOfInterest::getBoundingBoxes() const
+{
+    std::vector<std::pair<inet::Coord, inet::Coord>> boxes;
+    for (auto& circle : circles) {
+        inet::Coord r(circle.radius, circle.radius);
+        boxes.push_back(std::make_pair(circle.center - r, circle.center + r));
+    }
+    for (auto& polygon : polygons) {
+        boxes.push_back(std::make_pair(polygon.min, polygon.max));
+    }
+    return boxes;
+}
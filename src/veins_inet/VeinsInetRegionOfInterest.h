@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "inet/common/geometry/common/Coord.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * A region made up of circles and polygons (in OMNeT++ coordinates), e.g., the surroundings of RSUs and the area where events happen.
+ */
+class VEINS_INET_API VeinsInetRegionOfInterest {
+public:
+    /** @brief adds circles given as "x,y,r x,y,r ..." */
+    void addCircles(const std::string& circles);
+
+    /** @brief adds polygons given as "x,y x,y x,y ...; x,y x,y x,y ..." */
+    void addPolygons(const std::string& polygons);
+
+    void addCircle(const inet::Coord& center, double radius);
+    void addPolygon(const std::vector<inet::Coord>& points);
+
+    bool empty() const
+    {
+        return circles.empty() && polygons.empty();
+    }
+
+    /** @brief returns whether a position (ignoring its z coordinate) is inside any of the shapes */
+    bool contains(const inet::Coord& position) const;
+
+    /** @brief returns the bounding boxes of all shapes, as pairs of min and max corner */
+    std::vector<std::pair<inet::Coord, inet::Coord>> getBoundingBoxes() const;
+
+protected:
+    struct Circle {
+        inet::Coord center;
+        double radius;
+    };
+    struct Polygon {
+        std::vector<inet::Coord> points;
+        inet::Coord min; /**< min corner of bounding box */
+        inet::Coord max; /**< max corner of bounding box */
+    };
+
+    std::vector<Circle> circles;
+    std::vector<Polygon> polygons;
+};
+
+} // namespace veins
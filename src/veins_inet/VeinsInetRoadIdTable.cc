@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetRoadIdTable.h"
+
+using veins::VeinsInetRoadIdTable;
+
+VeinsInetRoadIdTable& VeinsInetRoadIdTable::getInstance()
+{
+    static VeinsInetRoadIdTable instance;
+    return instance;
+}
+
+VeinsInetRoadIdTable::VeinsInetRoadIdTable()
+{
+    intern("");
+}
+
+uint32_t VeinsInetRoadIdTable::intern(const std::string& roadId)
+{
+    auto i = indices.find(roadId);
+    if (i != indices.end()) return i->second;
+
+    uint32_t index = roadIds.size();
+    roadIds.push_back(roadId);
+    indices.emplace(roadId, index);
+    return index;
+}
+
+const std::string& VeinsInetRoadIdTable::lookup(uint32_t index) const
+{
+    if (index >= roadIds.size()) throw cRuntimeError("Unknown road index %u", index);
+    return roadIds[index];
+}
@@ -0,0 +1,68 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Table of road ids shared by all hosts, so messages can refer to a road by a compact index instead of its name.
+ *
+ * Index 0 stands for the empty road id (e.g., a vehicle not on any road).
+ */
+class VEINS_INET_API VeinsInetRoadIdTable {
+public:
+    static VeinsInetRoadIdTable& getInstance();
+
+    /**
+     * Returns the index of a road id, adding it to the table if it is new
+     */
+    uint32_t intern(const std::string& roadId);
+
+    /**
+     * Returns the road id with the given index
+     */
+    const std::string& lookup(uint32_t index) const;
+
+    size_t size() const
+    {
+        return roadIds.size();
+    }
+
+protected:
+    VeinsInetRoadIdTable();
+
+protected:
+    std::unordered_map<std::string, uint32_t> indices;
+    std::vector<std::string> roadIds;
+};
+
+} // namespace veins
@@ -22,8 +22,12 @@
 
 #include "veins_inet/VeinsInetSampleApplication.h"
 
+#include <cmath>
+#include <limits>
+
 #include "inet/common/ModuleAccess.h"
 #include "inet/common/packet/Packet.h"
+#include "inet/mobility/contract/IMobility.h"
 
 #include "inet/common/packet/printer/PacketPrinter.h"
 
@@ -36,12 +40,20 @@
 #include "inet/networklayer/common/L3AddressTag_m.h"
 #include "inet/transportlayer/contract/udp/UdpControlInfo_m.h"
 
+#include "veins_inet/VeinsInetRoadIdTable.h"
 #include "veins_inet/VeinsInetSampleMessage_m.h"
 
 using namespace inet;
 
 Define_Module(VeinsInetSampleApplication);
 
+veins::VeinsInetObjectPool& VeinsInetPooledSampleMessage::getPool()
+{
+    // never destroyed: payloads may still be queued in other modules when applications are deleted
+    static auto pool = new veins::VeinsInetObjectPool(sizeof(VeinsInetPooledSampleMessage));
+    return *pool;
+}
+
 VeinsInetSampleApplication::VeinsInetSampleApplication()
 {
     std::cout << "VeinsInetSampleApplication activated!";
@@ -49,103 +61,159 @@ VeinsInetSampleApplication::VeinsInetSampleApplication()
 
 bool VeinsInetSampleApplication::startApplication()
 {
-    // host[0] should stop at t=20s
-    if (getParentModule()->getIndex() == 0)
-    {
-        auto callback = [this]()
-        {
-            getParentModule()->getDisplayString().setTagArg("i", 1, "green");
-
-            //traciVehicle->setDecel(5);
-
-            traciVehicle->setSpeed(0);
-
-            auto payload = makeShared<VeinsInetSampleMessage>();
-            payload->setChunkLength(B(100));
-            payload->setRoadId(traciVehicle->getRoadId().c_str());
-            //std::string str = (const char*)traciVehicle->getSpeed();
-            //payload->getVehicleSpeed(str.c_str());
-            //setRoadId(traciVehicle->getRoadId().c_str());
-
-            payload->setRoadSpeed(traciVehicle->getSpeed());
-            payload->setAcceleration(traciVehicle->getAccel());
-            payload->setRoadHumidity("80");
-
-
-            //speedPayload(payload);
-
-            timestampPayload(payload);
-
-
-            //string newstr = traciVehicle->getSpeed();
-            //std::string info = "speed: 45, acceleration: 5, humidity: 50";
-            auto packet = createPacket("obstacle!");
-            haveForwarded = false;
-            packet->insertAtBack(payload);
-            ////Packet(const char *name, const Ptr<const Chunk>& content);
-            //packet->insertAtBack(traciVehicle->getSpeed());
-            sendPacket(std::move(packet));
-
-            // host should continue after 30s
-            auto callback = [this]()
-            {
-                traciVehicle->setSpeed(-1);
-                //traciVehicle->setSpeed(10);
-            };
-            timerManager.create(veins::TimerSpecification(callback).oneshotIn(SimTime(12, SIMTIME_S)));
-        };
-        timerManager.create(veins::TimerSpecification(callback).oneshotAt(SimTime(15, SIMTIME_S)));
+    // a pooled host restarted for another vehicle must neither remember nor forward what the previous one has seen
+    if (duplicateCache) duplicateCache->clear();
+    else duplicateCache.reset(new veins::VeinsInetDuplicateCache(par("duplicateCacheSize").intValue(), par("duplicateCacheLifetime").doubleValue()));
+    pendingForwards.clear();
+    geoBroadcast = par("geoBroadcast");
+    destinationRadius = par("destinationRadius");
+    hopLimit = par("hopLimit");
+    if (hopLimit < 0 || hopLimit > 255) throw cRuntimeError("hopLimit must be between 0 and 255, as messages encode it in one byte");
+    communicationRange = par("communicationRange");
+    maxForwardingDelay = par("maxForwardingDelay").doubleValue();
+    forwardingJitter = par("forwardingJitter").doubleValue();
+
+    // scripted incidents of this vehicle, e.g., stopping and warning others
+    std::vector<const veins::VeinsInetEventSchedule::Event*> scheduledEvents;
+    if (manager) manager->getEventSchedule().getEvents(mobility->getExternalId(), getParentModule()->getIndex(), scheduledEvents);
+    for (auto event : scheduledEvents) {
+        if (!event->isTimed()) {
+            pendingPositionEvents.push_back(event);
+            continue;
+        }
+        // a pooled host restarted later on has missed it
+        if (event->time < simTime()) continue;
+        timerManager->create(veins::TimerSpecification([this, event]() { executeEvent(*event); }).oneshotAt(event->time));
     }
+    // position triggers are checked on every move, as long as there are any left
+    if (!pendingPositionEvents.empty()) mobility->subscribe(inet::IMobility::mobilityStateChangedSignal, this);
 
-    if (getParentModule()->getIndex() == 4)
-    {
-        auto callback = [this]()
-        {
-            getParentModule()->getDisplayString().setTagArg("i", 1, "red");
-
-            //traciVehicle->setDecel(5);
-
-            traciVehicle->setSpeed(0);
-
-            auto payload = makeShared<VeinsInetSampleMessage>();
-            payload->setChunkLength(B(100));
-            payload->setRoadId(traciVehicle->getRoadId().c_str());
+    return true;
+}
 
-            timestampPayload(payload);
+bool VeinsInetSampleApplication::stopApplication()
+{
+    // timers are dropped along with the timer manager
+    pendingForwards.clear();
+    if (!pendingPositionEvents.empty()) mobility->unsubscribe(inet::IMobility::mobilityStateChangedSignal, this);
+    pendingPositionEvents.clear();
+    return true;
+}
 
+void VeinsInetSampleApplication::finish()
+{
+    VeinsInetApplicationBase::finish();
+
+    recordScalar("payloadAllocations", payloadAllocations);
+    recordScalar("payloadPoolReuses", payloadPoolReuses);
+
+    recordScalar("originatedMessages", originatedMessages);
+    recordScalar("expectedReceivers", expectedReceivers);
+    recordScalar("receivedMessages", receivedMessages);
+    recordScalar("receivedInArea", receivedInArea);
+    recordScalar("forwardedMessages", forwardedMessages);
+    recordScalar("cancelledForwards", cancelledForwards);
+    recordScalar("suppressedDuplicates", suppressedDuplicates);
+    // every distinct reception, whether forwarded or not, plus every duplicate
+    uint64_t received = receivedMessages + suppressedDuplicates;
+    if (received > 0) recordScalar("duplicateRate", double(suppressedDuplicates) / received);
+    recordScalar("suppressedBytes", suppressedBytes, "B");
+    if (duplicateCache) recordScalar("duplicateCacheMemory", duplicateCache->getMemoryUsage(), "B");
+    if (duplicateCache) recordScalar("duplicateCacheEvictions", duplicateCache->getEvictions());
+}
 
-            payload->setRoadSpeed(traciVehicle->getSpeed());
-            payload->setAcceleration(traciVehicle->getAccel());
-            payload->setRoadHumidity("40");
+inet::Ptr<VeinsInetSampleMessage> VeinsInetSampleApplication::createPayload()
+{
+    auto& pool = VeinsInetPooledSampleMessage::getPool();
+    uint64_t reuses = pool.getReuses();
+
+    auto payload = makeShared<VeinsInetPooledSampleMessage>();
+    payload->setOriginId(getParentModule()->getId());
+    payload->setSequenceNumber(nextSequenceNumber++);
+    originatedMessages++;
+
+    Coord position = mobility->getCurrentPosition();
+    payload->setSenderX(position.x);
+    payload->setSenderY(position.y);
+    payload->setDestinationX(position.x);
+    payload->setDestinationY(position.y);
+    payload->setDestinationRadius(destinationRadius);
+    payload->setHopsLeft(hopLimit);
+
+    // how many hosts should receive the message, for a delivery ratio
+    if (auto index = veins::VeinsInetSpatialIndexAccess().get()) {
+        size_t receivers = index->queryRange(position, destinationRadius > 0 ? destinationRadius : std::numeric_limits<double>::infinity()).size();
+        if (index->contains(getParentModule())) receivers--;
+        expectedReceivers += receivers;
+    }
 
+    // do not forward this message when neighbors echo it
+    duplicateCache->checkAndInsert(payload->getOriginId(), payload->getSequenceNumber(), simTime());
 
-            auto packet = createPacket("accident!");
-            haveForwarded = false;
+    payloadAllocations++;
+    if (pool.getReuses() != reuses) payloadPoolReuses++;
+    return payload;
+}
 
-            packet->insertAtBack(payload);
-            sendPacket(std::move(packet));
+VeinsInetSampleApplication::~VeinsInetSampleApplication()
+{
+}
 
-            // host should continue after 30s
-            auto callback = [this]()
-            {
-                traciVehicle->setSpeed(-1);
-                //traciVehicle->setSpeed(10);
-            };
-            timerManager.create(veins::TimerSpecification(callback).oneshotIn(SimTime(20, SIMTIME_S)));
-        };
-        timerManager.create(veins::TimerSpecification(callback).oneshotAt(SimTime(24, SIMTIME_S)));
+void VeinsInetSampleApplication::receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details)
+{
+    Enter_Method_Silent();
+
+    const inet::Coord& position = mobility->getCurrentPosition();
+    for (auto i = pendingPositionEvents.begin(); i != pendingPositionEvents.end();) {
+        const auto& event = **i;
+        if (std::hypot(position.x - event.position.x, position.y - event.position.y) > event.radius) {
+            ++i;
+            continue;
+        }
+        i = pendingPositionEvents.erase(i);
+        executeEvent(event);
     }
-
-    return true;
+    if (pendingPositionEvents.empty()) mobility->unsubscribe(inet::IMobility::mobilityStateChangedSignal, this);
 }
 
-bool VeinsInetSampleApplication::stopApplication()
+void VeinsInetSampleApplication::executeEvent(const veins::VeinsInetEventSchedule::Event& event)
 {
-    return true;
+    using Action = veins::VeinsInetEventSchedule::Action;
+
+    if (hasGUI() && !event.color.empty()) getParentModule()->getDisplayString().setTagArg("i", 1, event.color.c_str());
+
+    switch (event.action) {
+    case Action::STOP:
+        setVehicleSpeed(0);
+        if (event.duration > 0) timerManager->create(veins::TimerSpecification([this]() { setVehicleSpeed(-1); }).oneshotIn(event.duration));
+        break;
+    case Action::RESUME:
+        setVehicleSpeed(-1);
+        break;
+    case Action::SET_SPEED:
+        setVehicleSpeed(event.speed);
+        break;
+    case Action::WARN: {
+        auto payload = createPayload();
+        setVehicleState(payload);
+        payload->setRoadHumidity(event.humidity);
+        timestampPayload(payload);
+        auto packet = createPacket(event.message.c_str());
+        packet->insertAtBack(payload);
+        sendPacket(std::move(packet));
+        break;
+    }
+    }
 }
 
-VeinsInetSampleApplication::~VeinsInetSampleApplication()
+void VeinsInetSampleApplication::setVehicleState(const inet::Ptr<VeinsInetSampleMessage>& payload)
 {
+    const auto& snapshot = getVehicleSnapshot();
+    payload->setRoadId(snapshot.road);
+    payload->setRoadSpeed(snapshot.speed);
+    payload->setAcceleration(snapshot.acceleration);
+    // instead of getSpeed() and getAccel() of traciVehicle
+    traciQueriesAvoided += 2;
 }
 
 void VeinsInetSampleApplication::processPacket(std::shared_ptr<inet::Packet> pk)
@@ -154,21 +222,75 @@ void VeinsInetSampleApplication::processPacket(std::shared_ptr<inet::Packet> pk)
 
     EV_INFO << "Received packet: " << payload << endl;
 
+    // copies of a message arrive from every neighbor forwarding it, but carry nothing new
+    auto identity = std::make_pair(payload->getOriginId(), payload->getSequenceNumber());
+    if (duplicateCache->checkAndInsert(identity.first, identity.second, simTime())) {
+        suppressedDuplicates++;
+        suppressedBytes += pk->getByteLength();
+
+        // a host farther from the sender forwarded the message first
+        auto i = pendingForwards.find(identity);
+        if (i != pendingForwards.end()) {
+            timerManager->cancel(i->second);
+            pendingForwards.erase(i);
+            cancelledForwards++;
+        }
+        return;
+    }
 
+    receivedMessages++;
+    bool inArea = isInDestinationArea(*payload);
+    if (inArea) receivedInArea++;
 
-    getParentModule()->getDisplayString().setTagArg("i", 1, "green");
+    if (hasGUI()) getParentModule()->getDisplayString().setTagArg("i", 1, "green");
 
-    traciVehicle->changeRoute(payload->getRoadId(), 999.9);
+    changeVehicleRoute(veins::VeinsInetRoadIdTable::getInstance().lookup(payload->getRoadId()), 999.9);
 
     std::cout << "speed: " << payload->getRoadSpeed();
     std::cout << "  " << "acceleration: " << payload->getAcceleration();
-    std::cout << "  " << "humidity: " << payload->getRoadHumidity() << endl;
+    std::cout << "  " << "humidity: " << int(payload->getRoadHumidity()) << endl;
+
+    if (!geoBroadcast) {
+        auto packet = createPacket("Got it!");
+        packet->insertAtBack(payload);
+        sendPacket(std::move(packet));
+        forwardedMessages++;
+        return;
+    }
 
-    if (haveForwarded) return;
+    if (!inArea || payload->getHopsLeft() <= 1) return;
+    auto callback = [this, payload, identity]() {
+        pendingForwards.erase(identity);
+        forwardPayload(payload);
+    };
+    pendingForwards[identity] = timerManager->create(veins::TimerSpecification(callback).oneshotIn(getForwardingDelay(*payload)));
+}
+
+void VeinsInetSampleApplication::forwardPayload(const inet::Ptr<const VeinsInetSampleMessage>& payload)
+{
+    auto copy = staticPtrCast<VeinsInetSampleMessage>(payload->dupShared());
+    Coord position = mobility->getCurrentPosition();
+    copy->setSenderX(position.x);
+    copy->setSenderY(position.y);
+    copy->setHopsLeft(payload->getHopsLeft() - 1);
 
     auto packet = createPacket("Got it!");
-    packet->insertAtBack(payload);
+    packet->insertAtBack(copy);
     sendPacket(std::move(packet));
+    forwardedMessages++;
+}
 
-    haveForwarded = true;
+simtime_t VeinsInetSampleApplication::getForwardingDelay(const VeinsInetSampleMessage& payload) const
+{
+    Coord position = mobility->getCurrentPosition();
+    double distance = position.distance(Coord(payload.getSenderX(), payload.getSenderY(), position.z));
+    // the jitter keeps receivers at or beyond communicationRange (all of which get no distance-based delay) from colliding
+    return maxForwardingDelay * std::max(0.0, 1 - distance / communicationRange) + uniform(0, forwardingJitter.dbl());
+}
+
+bool VeinsInetSampleApplication::isInDestinationArea(const VeinsInetSampleMessage& payload) const
+{
+    if (payload.getDestinationRadius() <= 0) return true;
+    Coord position = mobility->getCurrentPosition();
+    return position.distance(Coord(payload.getDestinationX(), payload.getDestinationY(), position.z)) <= payload.getDestinationRadius();
 }
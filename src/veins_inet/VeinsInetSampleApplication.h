@@ -24,16 +24,92 @@
 
 #include "veins_inet/veins_inet.h"
 
+#include <map>
+#include <utility>
+#include <vector>
+
 #include "veins_inet/VeinsInetApplicationBase.h"
+#include "veins_inet/VeinsInetDuplicateCache.h"
+#include "veins_inet/VeinsInetEventSchedule.h"
+#include "veins_inet/VeinsInetObjectPool.h"
+#include "veins_inet/VeinsInetSampleMessage_m.h"
+
+/**
+ * VeinsInetSampleMessage allocated from a pool shared by all applications, as payloads are created and dropped at a high rate
+ */
+class VEINS_INET_API VeinsInetPooledSampleMessage : public VeinsInetSampleMessage {
+public:
+    VeinsInetPooledSampleMessage() = default;
+    VeinsInetPooledSampleMessage(const VeinsInetPooledSampleMessage& other) = default;
+    virtual VeinsInetPooledSampleMessage* dup() const override
+    {
+        return new VeinsInetPooledSampleMessage(*this);
+    }
 
-class VEINS_INET_API VeinsInetSampleApplication : public veins::VeinsInetApplicationBase {
+    static void* operator new(size_t size)
+    {
+        return getPool().allocate(size);
+    }
+    static void operator delete(void* p, size_t size)
+    {
+        getPool().deallocate(p, size);
+    }
+
+    static veins::VeinsInetObjectPool& getPool();
+};
+
+class VEINS_INET_API VeinsInetSampleApplication : public veins::VeinsInetApplicationBase, public cListener {
 protected:
-    bool haveForwarded = false;
+    uint32_t nextSequenceNumber = 0; /**< sequence number of the next message this host originates (kept over restarts, so identities stay unique) */
+    std::unique_ptr<veins::VeinsInetDuplicateCache> duplicateCache; /**< identities of the messages already forwarded or originated */
+    uint64_t forwardedMessages = 0; /**< number of messages forwarded */
+    uint64_t suppressedDuplicates = 0; /**< number of received messages that were not processed as they had been seen before */
+    uint64_t suppressedBytes = 0; /**< number of bytes that were not sent again thanks to duplicate suppression */
+
+    bool geoBroadcast = false; /**< whether to forward by contention (farthest receiver first) within the destination area, instead of flooding */
+    double destinationRadius = 0; /**< radius of the destination area around the origin of a message */
+    int hopLimit = 0; /**< number of times a message may be sent, counting its origination */
+    double communicationRange = 0; /**< distance from the sender at which the forwarding delay reaches zero */
+    simtime_t maxForwardingDelay; /**< forwarding delay right at the sender */
+    simtime_t forwardingJitter; /**< upper bound of the random delay added to every forward */
+    std::map<std::pair<int, uint32_t>, veins::TimerHandle> pendingForwards; /**< contention timers of messages waiting to be forwarded, by identity */
+
+    uint64_t originatedMessages = 0; /**< number of messages originated */
+    uint64_t expectedReceivers = 0; /**< number of other hosts in the destination area of originated messages at origination (if the manager keeps a spatial index) */
+    uint64_t receivedMessages = 0; /**< number of distinct messages received */
+    uint64_t receivedInArea = 0; /**< number of distinct messages received inside their destination area */
+    uint64_t cancelledForwards = 0; /**< number of forwards cancelled on overhearing a host farther away forward first */
+
+    uint64_t payloadAllocations = 0; /**< number of payloads created */
+    uint64_t payloadPoolReuses = 0; /**< number of payloads created in memory freed by earlier ones */
+
+    std::vector<const veins::VeinsInetEventSchedule::Event*> pendingPositionEvents; /**< scripted incidents of this vehicle triggered by position that have not fired yet (owned by the manager's schedule) */
 
 protected:
     virtual bool startApplication() override;
     virtual bool stopApplication() override;
     virtual void processPacket(std::shared_ptr<inet::Packet> pk) override;
+    virtual void finish() override;
+
+    /** @brief returns a new, pooled payload with an identity of its own, destined to the area around this host */
+    virtual inet::Ptr<VeinsInetSampleMessage> createPayload();
+
+    /** @brief sends a copy of a received payload on, as sent from this host */
+    virtual void forwardPayload(const inet::Ptr<const VeinsInetSampleMessage>& payload);
+
+    /** @brief returns how long to wait before forwarding a payload: the farther from its sender, the shorter */
+    virtual simtime_t getForwardingDelay(const VeinsInetSampleMessage& payload) const;
+
+    bool isInDestinationArea(const VeinsInetSampleMessage& payload) const;
+
+    /** @brief checks the position triggers of pending events whenever the vehicle moves */
+    virtual void receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details) override;
+
+    /** @brief carries out a scripted incident of this vehicle */
+    virtual void executeEvent(const veins::VeinsInetEventSchedule::Event& event);
+
+    /** @brief copies road, speed, and acceleration of this vehicle into the payload */
+    virtual void setVehicleState(const inet::Ptr<VeinsInetSampleMessage>& payload);
 
 public:
     VeinsInetSampleApplication();
@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetSampleMessageSerializer.h"
+
+#include <cstring>
+
+#include "inet/common/packet/serializer/ChunkSerializerRegistry.h"
+
+#include "veins_inet/VeinsInetSampleApplication.h"
+#include "veins_inet/VeinsInetSampleMessage_m.h"
+
+using namespace inet;
+using veins::VeinsInetSampleMessageSerializer;
+
+Register_Serializer(VeinsInetSampleMessage, VeinsInetSampleMessageSerializer);
+// serializers are looked up by exact type, so the pooled subclass the sample application sends needs its own entry
+Register_Serializer(VeinsInetPooledSampleMessage, VeinsInetSampleMessageSerializer);
+
+namespace {
+
+const uint8_t currentVersion = 1;
+
+void writeFloat(MemoryOutputStream& stream, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    stream.writeUint32Be(bits);
+}
+
+float readFloat(MemoryInputStream& stream)
+{
+    uint32_t bits = stream.readUint32Be();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+void VeinsInetSampleMessageSerializer::serialize(MemoryOutputStream& stream, const Ptr<const Chunk>& chunk) const
+{
+    b start = stream.getLength();
+    const auto& message = staticPtrCast<const VeinsInetSampleMessage>(chunk);
+    stream.writeByte(message->getVersion());
+    stream.writeByte(message->getHopsLeft());
+    stream.writeByte(message->getRoadHumidity());
+    stream.writeByte(0);
+    stream.writeUint32Be(static_cast<uint32_t>(message->getOriginId()));
+    stream.writeUint32Be(message->getSequenceNumber());
+    stream.writeUint32Be(message->getRoadId());
+    writeFloat(stream, message->getRoadSpeed());
+    writeFloat(stream, message->getAcceleration());
+    writeFloat(stream, message->getSenderX());
+    writeFloat(stream, message->getSenderY());
+    writeFloat(stream, message->getDestinationX());
+    writeFloat(stream, message->getDestinationY());
+    writeFloat(stream, message->getDestinationRadius());
+    ASSERT(stream.getLength() - start == message->getChunkLength());
+}
+
+const Ptr<Chunk> VeinsInetSampleMessageSerializer::deserialize(MemoryInputStream& stream) const
+{
+    auto message = makeShared<VeinsInetSampleMessage>();
+    message->setVersion(stream.readByte());
+    // decode the known fields anyway, so the message keeps its length
+    if (message->getVersion() != currentVersion) message->markIncorrect();
+    message->setHopsLeft(stream.readByte());
+    message->setRoadHumidity(stream.readByte());
+    stream.readByte();
+    message->setOriginId(static_cast<int32_t>(stream.readUint32Be()));
+    message->setSequenceNumber(stream.readUint32Be());
+    message->setRoadId(stream.readUint32Be());
+    message->setRoadSpeed(readFloat(stream));
+    message->setAcceleration(readFloat(stream));
+    message->setSenderX(readFloat(stream));
+    message->setSenderY(readFloat(stream));
+    message->setDestinationX(readFloat(stream));
+    message->setDestinationY(readFloat(stream));
+    message->setDestinationRadius(readFloat(stream));
+    return message;
+}
@@ -0,0 +1,48 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include "veins_inet/veins_inet.h"
+
+#include "inet/common/packet/serializer/FieldsChunkSerializer.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Converts between VeinsInetSampleMessage and its fixed-width binary encoding (see VeinsInetSampleMessage.msg)
+ */
+class VEINS_INET_API VeinsInetSampleMessageSerializer : public inet::FieldsChunkSerializer {
+protected:
+    virtual void serialize(inet::MemoryOutputStream& stream, const inet::Ptr<const inet::Chunk>& chunk) const override;
+    virtual const inet::Ptr<inet::Chunk> deserialize(inet::MemoryInputStream& stream) const override;
+
+public:
+    VeinsInetSampleMessageSerializer()
+        : inet::FieldsChunkSerializer()
+    {
+    }
+};
+
+} // namespace veins
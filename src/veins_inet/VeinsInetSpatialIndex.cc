@@ -0,0 +1,260 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using veins::VeinsInetSpatialIndex;
+
+VeinsInetSpatialIndex::VeinsInetSpatialIndex(double cellSize)
+    : cellSize(cellSize)
+{
+    if (!(cellSize > 0)) throw cRuntimeError("Spatial index needs a positive cell size, not %g", cellSize);
+}
+
+int32_t VeinsInetSpatialIndex::cellIndex(double coordinate) const
+{
+    return static_cast<int32_t>(std::floor(coordinate / cellSize));
+}
+
+size_t VeinsInetSpatialIndex::addMember(std::vector<Member>& members, cModule* host, const inet::Coord& position)
+{
+    members.push_back({host, position.x, position.y});
+    return members.size() - 1;
+}
+
+void VeinsInetSpatialIndex::removeMember(std::vector<Member>& members, size_t slot, size_t Entry::*slotOf)
+{
+    ASSERT(slot < members.size());
+    if (slot + 1 != members.size()) {
+        members[slot] = members.back();
+        entries.at(members[slot].host).*slotOf = slot;
+    }
+    members.pop_back();
+}
+
+void VeinsInetSpatialIndex::leaveCell(const Entry& entry)
+{
+    auto i = cells.find(entry.cell);
+    ASSERT(i != cells.end());
+    removeMember(i->second, entry.cellSlot, &Entry::cellSlot);
+    if (i->second.empty()) cells.erase(i);
+}
+
+void VeinsInetSpatialIndex::leaveRoad(const Entry& entry)
+{
+    if (entry.road == 0) return;
+    auto i = roads.find(entry.road);
+    ASSERT(i != roads.end());
+    removeMember(i->second, entry.roadSlot, &Entry::roadSlot);
+    if (i->second.empty()) roads.erase(i);
+}
+
+void VeinsInetSpatialIndex::insert(cModule* host, const inet::Coord& position, uint32_t road)
+{
+    if (contains(host)) throw cRuntimeError("Host %s is already in the spatial index", host->getFullPath().c_str());
+
+    Entry& entry = entries[host];
+    entry.position = position;
+    entry.cell = cellKey(cellIndex(position.x), cellIndex(position.y));
+    entry.cellSlot = addMember(cells[entry.cell], host, position);
+    entry.road = road;
+    if (road != 0) entry.roadSlot = addMember(roads[road], host, position);
+}
+
+void VeinsInetSpatialIndex::move(cModule* host, const inet::Coord& position, uint32_t road)
+{
+    auto i = entries.find(host);
+    if (i == entries.end()) throw cRuntimeError("Host %s is not in the spatial index", host->getFullPath().c_str());
+    Entry& entry = i->second;
+
+    entry.position = position;
+    int64_t cell = cellKey(cellIndex(position.x), cellIndex(position.y));
+    if (cell != entry.cell) {
+        leaveCell(entry);
+        entry.cell = cell;
+        entry.cellSlot = addMember(cells[cell], host, position);
+    }
+    else {
+        Member& member = cells.at(cell)[entry.cellSlot];
+        member.x = position.x;
+        member.y = position.y;
+    }
+
+    if (road != entry.road) {
+        leaveRoad(entry);
+        entry.road = road;
+        if (road != 0) entry.roadSlot = addMember(roads[road], host, position);
+    }
+    else if (road != 0) {
+        Member& member = roads.at(road)[entry.roadSlot];
+        member.x = position.x;
+        member.y = position.y;
+    }
+}
+
+void VeinsInetSpatialIndex::remove(cModule* host)
+{
+    auto i = entries.find(host);
+    if (i == entries.end()) return;
+
+    leaveCell(i->second);
+    leaveRoad(i->second);
+    entries.erase(i);
+}
+
+const inet::Coord& VeinsInetSpatialIndex::getPosition(const cModule* host) const
+{
+    auto i = entries.find(host);
+    if (i == entries.end()) throw cRuntimeError("Host %s is not in the spatial index", host->getFullPath().c_str());
+    return i->second.position;
+}
+
+void VeinsInetSpatialIndex::collect(int32_t cx, int32_t cy, const inet::Coord& center, double radius2, std::vector<std::pair<double, cModule*>>& result) const
+{
+    auto i = cells.find(cellKey(cx, cy));
+    if (i == cells.end()) return;
+    for (auto& e : i->second) {
+        double dx = e.x - center.x;
+        double dy = e.y - center.y;
+        double d2 = dx * dx + dy * dy;
+        if (d2 <= radius2) result.emplace_back(d2, e.host);
+    }
+}
+
+std::vector<cModule*> VeinsInetSpatialIndex::queryRange(const inet::Coord& center, double radius) const
+{
+    // distances are not needed for sorting, so hosts go into the result right away
+    std::vector<cModule*> result;
+    double radius2 = radius * radius;
+    auto collectCell = [&center, radius2, &result](const std::vector<Member>& hosts) {
+        for (auto& e : hosts) {
+            double dx = e.x - center.x;
+            double dy = e.y - center.y;
+            if (dx * dx + dy * dy <= radius2) result.push_back(e.host);
+        }
+    };
+
+    // if the query covers more cells than are occupied (e.g., for an infinite radius), visit the occupied ones instead
+    double spanX = std::floor((center.x + radius) / cellSize) - std::floor((center.x - radius) / cellSize) + 1;
+    double spanY = std::floor((center.y + radius) / cellSize) - std::floor((center.y - radius) / cellSize) + 1;
+    if (spanX * spanY > cells.size()) {
+        for (auto& cell : cells) {
+            collectCell(cell.second);
+        }
+        return result;
+    }
+
+    for (int32_t cx = cellIndex(center.x - radius); cx <= cellIndex(center.x + radius); cx++) {
+        for (int32_t cy = cellIndex(center.y - radius); cy <= cellIndex(center.y + radius); cy++) {
+            auto i = cells.find(cellKey(cx, cy));
+            if (i != cells.end()) collectCell(i->second);
+        }
+    }
+    return result;
+}
+
+std::vector<cModule*> VeinsInetSpatialIndex::queryNearest(const inet::Coord& center, size_t k, const cModule* exclude) const
+{
+    std::vector<std::pair<double, cModule*>> found;
+    size_t available = entries.size() - (exclude && contains(exclude) ? 1 : 0);
+    k = std::min(k, available);
+    if (k == 0) return {};
+
+    // search rings of cells around the center until k hosts are found that are closer than any host outside the rings could be
+    int32_t x0 = cellIndex(center.x);
+    int32_t y0 = cellIndex(center.y);
+    const double infinity = std::numeric_limits<double>::infinity();
+    auto isExcluded = [exclude](const std::pair<double, cModule*>& f) { return f.second == exclude; };
+    for (int32_t ring = 0;; ring++) {
+        // once the next ring has more cells than are occupied (e.g., for a host far from all others), take all hosts instead
+        if (8 * static_cast<size_t>(ring) > cells.size()) {
+            found.clear();
+            for (auto& cell : cells) {
+                for (auto& e : cell.second) {
+                    double dx = e.x - center.x;
+                    double dy = e.y - center.y;
+                    found.emplace_back(dx * dx + dy * dy, e.host);
+                }
+            }
+            found.erase(std::remove_if(found.begin(), found.end(), isExcluded), found.end());
+            break;
+        }
+
+        // visit the cells on the border of the ring only, the inner ones were visited before
+        if (ring == 0) {
+            collect(x0, y0, center, infinity, found);
+        }
+        else {
+            for (int32_t cx = x0 - ring; cx <= x0 + ring; cx++) {
+                collect(cx, y0 - ring, center, infinity, found);
+                collect(cx, y0 + ring, center, infinity, found);
+            }
+            for (int32_t cy = y0 - ring + 1; cy < y0 + ring; cy++) {
+                collect(x0 - ring, cy, center, infinity, found);
+                collect(x0 + ring, cy, center, infinity, found);
+            }
+        }
+        found.erase(std::remove_if(found.begin(), found.end(), isExcluded), found.end());
+        if (found.size() < k) continue;
+        if (found.size() >= available) break;
+
+        // hosts outside the rings searched so far are at least as far away as the nearest border of the rings
+        double reach = std::min(std::min(center.x - (x0 - ring) * cellSize, (x0 + ring + 1) * cellSize - center.x), std::min(center.y - (y0 - ring) * cellSize, (y0 + ring + 1) * cellSize - center.y));
+        std::nth_element(found.begin(), found.begin() + (k - 1), found.end());
+        if (found[k - 1].first <= reach * reach) break;
+    }
+
+    std::partial_sort(found.begin(), found.begin() + k, found.end());
+    std::vector<cModule*> result;
+    result.reserve(k);
+    for (size_t i = 0; i < k; i++) {
+        result.push_back(found[i].second);
+    }
+    return result;
+}
+
+std::vector<cModule*> VeinsInetSpatialIndex::queryRoad(uint32_t road, const inet::Coord& center, double radius) const
+{
+    std::vector<std::pair<double, cModule*>> found;
+    auto r = roads.find(road);
+    if (r != roads.end()) {
+        for (auto& e : r->second) {
+            double dx = e.x - center.x;
+            double dy = e.y - center.y;
+            double d2 = dx * dx + dy * dy;
+            if (d2 <= radius * radius) found.emplace_back(d2, e.host);
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<cModule*> result;
+    result.reserve(found.size());
+    for (auto& f : found) {
+        result.push_back(f.second);
+    }
+    return result;
+}
@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "inet/common/geometry/common/Coord.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Uniform grid of the positions (in OMNeT++ coordinates, ignoring z) of vehicles and RSUs, for range, k-nearest, and along-road queries.
+ *
+ * Maintained incrementally by VeinsInetManagerBase as vehicles are added, moved, and removed, if its spatialIndexCellSize parameter is set.
+ * Queries only visit the cells overlapping the query area (or the occupied cells, if there are fewer), so their cost depends on the local density, not on the total number of hosts.
+ * Cells and roads store the positions of their hosts, so queries scan contiguous arrays.
+ * Cells should be about as large as the typical query radius (see VeinsInetSpatialIndexBenchmark).
+ */
+class VEINS_INET_API VeinsInetSpatialIndex {
+public:
+    VeinsInetSpatialIndex(double cellSize);
+
+    /** @brief adds a host, on a road given by its index in VeinsInetRoadIdTable (0 for none, e.g., for an RSU) */
+    void insert(cModule* host, const inet::Coord& position, uint32_t road = 0);
+
+    /** @brief moves a host already in the index */
+    void move(cModule* host, const inet::Coord& position, uint32_t road = 0);
+
+    void remove(cModule* host);
+
+    bool contains(const cModule* host) const
+    {
+        return entries.find(host) != entries.end();
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    /** @brief returns all hosts within radius of center (in no particular order) */
+    std::vector<cModule*> queryRange(const inet::Coord& center, double radius) const;
+
+    /** @brief returns the k hosts closest to center, closest first, ignoring exclude (e.g., the asking host) */
+    std::vector<cModule*> queryNearest(const inet::Coord& center, size_t k, const cModule* exclude = nullptr) const;
+
+    /** @brief returns all vehicles on a road within radius of center, closest first */
+    std::vector<cModule*> queryRoad(uint32_t road, const inet::Coord& center, double radius) const;
+
+    /** @brief returns the position a host had when last inserted or moved */
+    const inet::Coord& getPosition(const cModule* host) const;
+
+protected:
+    struct Entry {
+        inet::Coord position;
+        int64_t cell;
+        size_t cellSlot; /**< position of the host among the members of its cell */
+        uint32_t road;
+        size_t roadSlot; /**< position of the host among the members of its road (if on a road) */
+    };
+
+    /** @brief a host and its position, as stored in its cell and on its road, so queries need not look up entries */
+    struct Member {
+        cModule* host;
+        double x;
+        double y;
+    };
+
+    int32_t cellIndex(double coordinate) const;
+    int64_t cellKey(int32_t cx, int32_t cy) const
+    {
+        return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    /** @brief appends a host to the members of a cell or road, returning its slot there */
+    size_t addMember(std::vector<Member>& members, cModule* host, const inet::Coord& position);
+    /** @brief removes the member in a slot of a cell or road, moving the last member (whose slot is stored in slotOf of its entry) into its place */
+    void removeMember(std::vector<Member>& members, size_t slot, size_t Entry::*slotOf);
+    void leaveCell(const Entry& entry);
+    void leaveRoad(const Entry& entry);
+
+    /** @brief appends the hosts of one cell within radius of center (squared) to result */
+    void collect(int32_t cx, int32_t cy, const inet::Coord& center, double radius2, std::vector<std::pair<double, cModule*>>& result) const;
+
+protected:
+    double cellSize;
+    std::unordered_map<const cModule*, Entry> entries;
+    std::unordered_map<int64_t, std::vector<Member>> cells;
+    std::unordered_map<uint32_t, std::vector<Member>> roads; /**< vehicles by road */
+};
+
+} // namespace veins
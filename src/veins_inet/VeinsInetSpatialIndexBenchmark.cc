@@ -0,0 +1,190 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#include "veins_inet/VeinsInetSpatialIndexBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+using veins::VeinsInetSpatialIndex;
+using veins::VeinsInetSpatialIndexBenchmark;
+
+Define_Module(veins::VeinsInetSpatialIndexBenchmark);
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+void VeinsInetSpatialIndexBenchmark::initialize()
+{
+    areaSize = par("areaSize");
+    numRoads = par("numRoads").intValue();
+    maxMove = par("maxMove");
+    roadChangeProbability = par("roadChangeProbability");
+    if (numRoads < 1) throw cRuntimeError("numRoads must be at least 1");
+
+    VeinsInetSpatialIndex index(par("cellSize").doubleValue());
+    const char* hostVector = par("hostVector");
+    for (cModule::SubmoduleIterator it(getParentModule()); !it.end(); ++it) {
+        if (!(*it)->isName(hostVector)) continue;
+        // road 0 means "on no road" to the index
+        Host host{*it, inet::Coord(uniform(0, areaSize), uniform(0, areaSize)), 1 + static_cast<uint32_t>(intrand(numRoads))};
+        index.insert(host.module, host.position, host.road);
+        slots[host.module] = hosts.size();
+        hosts.push_back(host);
+    }
+    if (hosts.size() < 2) throw cRuntimeError("Need at least two modules named \"%s\" to query", hostVector);
+
+    double radius = par("queryRadius");
+    size_t k = par("nearestCount").intValue();
+    int numQueries = par("numQueries");
+    int numSteps = par("numSteps");
+    for (int step = 0; step < numSteps; step++) {
+        for (int q = 0; q < numQueries; q++) {
+            const Host& at = hosts[intrand(hosts.size())];
+            queries++;
+
+            auto start = Clock::now();
+            auto inRange = index.queryRange(at.position, radius);
+            range.index += seconds(start);
+            start = Clock::now();
+            auto scannedRange = scanRange(at.position, radius);
+            range.scan += seconds(start);
+            rangeResults += inRange.size();
+            std::sort(inRange.begin(), inRange.end());
+            std::sort(scannedRange.begin(), scannedRange.end());
+            if (inRange != scannedRange) throw cRuntimeError("Range query at (%g, %g) found %zu hosts, the scan %zu", at.position.x, at.position.y, inRange.size(), scannedRange.size());
+
+            start = Clock::now();
+            auto closest = index.queryNearest(at.position, k, at.module);
+            nearest.index += seconds(start);
+            start = Clock::now();
+            auto scannedDistances = scanNearest(at.position, k, at.module);
+            nearest.scan += seconds(start);
+            // hosts at equal distance may be picked in any order, so compare distances
+            std::vector<double> distances;
+            for (auto module : closest) {
+                if (module == at.module) throw cRuntimeError("k-nearest query returned the excluded host %s", module->getFullPath().c_str());
+                distances.push_back(distance2(hosts[slots.at(module)], at.position));
+            }
+            if (distances != scannedDistances) throw cRuntimeError("k-nearest query at %s differs from the scan", at.module->getFullPath().c_str());
+            if (std::set<cModule*>(closest.begin(), closest.end()).size() != closest.size()) throw cRuntimeError("k-nearest query at %s returned a host twice", at.module->getFullPath().c_str());
+
+            start = Clock::now();
+            auto onRoad = index.queryRoad(at.road, at.position, radius);
+            road.index += seconds(start);
+            start = Clock::now();
+            auto scannedRoad = scanRoad(at.road, at.position, radius);
+            road.scan += seconds(start);
+            if (onRoad != scannedRoad) throw cRuntimeError("Road query at %s found %zu hosts, the scan %zu (or in a different order)", at.module->getFullPath().c_str(), onRoad.size(), scannedRoad.size());
+        }
+        moveHosts(index);
+    }
+}
+
+void VeinsInetSpatialIndexBenchmark::finish()
+{
+    recordScalar("hosts", hosts.size());
+    recordScalar("queries", queries);
+    recordScalar("meanRangeResults", queries > 0 ? double(rangeResults) / queries : 0);
+    if (queries == 0) return;
+
+    const std::pair<const char*, const Timing*> kinds[] = {{"range", &range}, {"nearest", &nearest}, {"road", &road}};
+    for (auto& kind : kinds) {
+        const Timing& timing = *kind.second;
+        recordScalar(opp_stringf("%sQueryTime", kind.first).c_str(), timing.index / queries, "s");
+        recordScalar(opp_stringf("%sScanTime", kind.first).c_str(), timing.scan / queries, "s");
+        if (timing.index > 0) recordScalar(opp_stringf("%sSpeedup", kind.first).c_str(), timing.scan / timing.index);
+        EV_INFO << kind.first << " queries of " << hosts.size() << " hosts: " << timing.index / queries * 1e6 << " us (index) vs. " << timing.scan / queries * 1e6 << " us (scan)" << endl;
+    }
+}
+
+double VeinsInetSpatialIndexBenchmark::distance2(const Host& host, const inet::Coord& center) const
+{
+    // same arithmetic as the index, so distances compare equal
+    double dx = host.position.x - center.x;
+    double dy = host.position.y - center.y;
+    return dx * dx + dy * dy;
+}
+
+std::vector<cModule*> VeinsInetSpatialIndexBenchmark::scanRange(const inet::Coord& center, double radius) const
+{
+    std::vector<cModule*> result;
+    for (auto& host : hosts) {
+        if (distance2(host, center) <= radius * radius) result.push_back(host.module);
+    }
+    return result;
+}
+
+std::vector<double> VeinsInetSpatialIndexBenchmark::scanNearest(const inet::Coord& center, size_t k, const cModule* exclude) const
+{
+    std::vector<double> found;
+    found.reserve(hosts.size());
+    for (auto& host : hosts) {
+        if (host.module != exclude) found.push_back(distance2(host, center));
+    }
+    k = std::min(k, found.size());
+    std::partial_sort(found.begin(), found.begin() + k, found.end());
+    found.resize(k);
+    return found;
+}
+
+std::vector<cModule*> VeinsInetSpatialIndexBenchmark::scanRoad(uint32_t road, const inet::Coord& center, double radius) const
+{
+    std::vector<std::pair<double, cModule*>> found;
+    for (auto& host : hosts) {
+        if (host.road != road) continue;
+        double d2 = distance2(host, center);
+        if (d2 <= radius * radius) found.emplace_back(d2, host.module);
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<cModule*> result;
+    result.reserve(found.size());
+    for (auto& f : found) {
+        result.push_back(f.second);
+    }
+    return result;
+}
+
+void VeinsInetSpatialIndexBenchmark::moveHosts(VeinsInetSpatialIndex& index)
+{
+    double moveFraction = par("moveFraction");
+    for (auto& host : hosts) {
+        if (uniform(0, 1) >= moveFraction) continue;
+        // stay inside the area, crossing cell borders now and then
+        host.position.x = std::min(std::max(host.position.x + uniform(-maxMove, maxMove), 0.0), areaSize);
+        host.position.y = std::min(std::max(host.position.y + uniform(-maxMove, maxMove), 0.0), areaSize);
+        if (uniform(0, 1) < roadChangeProbability) host.road = 1 + intrand(numRoads);
+        index.move(host.module, host.position, host.road);
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins_inet/VeinsInetSpatialIndex.h"
+#include "inet/common/geometry/common/Coord.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Checks VeinsInetSpatialIndex against a linear scan over all hosts, for both results and time per query.
+ *
+ * Places the modules of the hostVector of its parent at random in a square area, each on one of numRoads roads,
+ * then, for numSteps steps, runs numQueries range, k-nearest, and along-road queries at random hosts and moves part of the hosts.
+ * Any difference between the results of index and scan is an error (k-nearest results may differ only among hosts at equal distance).
+ * Time per query of both is recorded as scalars by finish().
+ */
+class VEINS_INET_API VeinsInetSpatialIndexBenchmark : public cSimpleModule {
+public:
+    void initialize() override;
+    void finish() override;
+
+protected:
+    struct Host {
+        cModule* module;
+        inet::Coord position;
+        uint32_t road;
+    };
+
+    /** @brief wall clock time (s) spent by index and scan on one kind of query */
+    struct Timing {
+        double index = 0;
+        double scan = 0;
+    };
+
+    double distance2(const Host& host, const inet::Coord& center) const;
+
+    std::vector<cModule*> scanRange(const inet::Coord& center, double radius) const;
+    std::vector<double> scanNearest(const inet::Coord& center, size_t k, const cModule* exclude) const;
+    std::vector<cModule*> scanRoad(uint32_t road, const inet::Coord& center, double radius) const;
+
+    void moveHosts(VeinsInetSpatialIndex& index);
+
+protected:
+    double areaSize;
+    uint32_t numRoads;
+    double maxMove; /**< farthest a host moves in one step */
+    double roadChangeProbability; /**< chance of a moving host to change roads */
+    std::vector<Host> hosts;
+    std::unordered_map<const cModule*, size_t> slots; /**< position of every host in hosts */
+
+    Timing range;
+    Timing nearest;
+    Timing road;
+    uint64_t queries = 0; /**< number of queries of each kind */
+    uint64_t rangeResults = 0; /**< number of hosts found by all range queries */
+};
+
+} // namespace veins
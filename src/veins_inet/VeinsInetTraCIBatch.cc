@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins_inet/VeinsInetTraCIBatch.h"
+
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+
+using namespace veins::TraCIConstants;
+
+using veins::TraCIBuffer;
+using veins::VeinsInetTraCIBatch;
+
+VeinsInetTraCIBatch::VeinsInetTraCIBatch(TraCIConnection* connection)
+    : connection(connection)
+{
+    ASSERT(connection);
+}
+
+void VeinsInetTraCIBatch::add(uint8_t commandId, const TraCIBuffer& buf)
+{
+    message += makeTraCICommand(commandId, buf);
+    commandCount++;
+}
+
+TraCIBuffer VeinsInetTraCIBatch::execute()
+{
+    ASSERT(!empty());
+
+    connection->sendMessage(message);
+    TraCIBuffer buf(connection->receiveMessage());
+
+    message.clear();
+    commandCount = 0;
+
+    return buf;
+}
+
+void VeinsInetTraCIBatch::readStatus(TraCIBuffer& buf, uint8_t commandId)
+{
+    uint8_t cmdLength;
+    buf >> cmdLength;
+    if (cmdLength == 0) {
+        uint32_t cmdLengthExt;
+        buf >> cmdLengthExt;
+    }
+    uint8_t commandResp;
+    buf >> commandResp;
+    ASSERT(commandResp == commandId);
+    uint8_t result;
+    buf >> result;
+    std::string description;
+    buf >> description;
+    if (result == RTYPE_NOTIMPLEMENTED) throw cRuntimeError("TraCI server reported command 0x%2x not implemented (\"%s\"). Might need newer version.", commandId, description.c_str());
+    if (result != RTYPE_OK) throw cRuntimeError("TraCI server reported error executing command 0x%2x (\"%s\").", commandId, description.c_str());
+}
+
+void VeinsInetTraCIBatch::readResponseHeader(TraCIBuffer& buf, uint8_t responseId, uint8_t variableId, const std::string& objectId, uint8_t resultTypeId)
+{
+    uint8_t cmdLength;
+    buf >> cmdLength;
+    if (cmdLength == 0) {
+        uint32_t cmdLengthExt;
+        buf >> cmdLengthExt;
+    }
+    uint8_t commandId_r;
+    buf >> commandId_r;
+    ASSERT(commandId_r == responseId);
+    uint8_t varId;
+    buf >> varId;
+    ASSERT(varId == variableId);
+    std::string objectId_r;
+    buf >> objectId_r;
+    ASSERT(objectId_r == objectId);
+    uint8_t resType_r;
+    buf >> resType_r;
+    ASSERT(resType_r == resultTypeId);
+}
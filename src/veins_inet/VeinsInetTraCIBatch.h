@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Sends any number of TraCI commands as a single message and reads all of their responses in one go.
+ *
+ * TraCIConnection::query() costs one socket round trip per command.
+ * SUMO accepts several commands per message and answers them, in order, in a single response message,
+ * so a batch costs one round trip no matter how many commands it holds.
+ *
+ */
+class VEINS_INET_API VeinsInetTraCIBatch {
+public:
+    explicit VeinsInetTraCIBatch(TraCIConnection* connection);
+
+    /** @brief queues a command, to be sent by execute() */
+    void add(uint8_t commandId, const TraCIBuffer& buf = TraCIBuffer());
+
+    size_t size() const
+    {
+        return commandCount;
+    }
+
+    bool empty() const
+    {
+        return commandCount == 0;
+    }
+
+    /**
+     * Sends all queued commands as one message and returns the response message.
+     * Responses have to be consumed in the order the commands were added, using readStatus() and readResult().
+     */
+    TraCIBuffer execute();
+
+    /** @brief consumes the status response of a command, throws if the command failed */
+    static void readStatus(TraCIBuffer& buf, uint8_t commandId);
+
+    /** @brief consumes the status and result of a variable retrieval command (e.g., CMD_GET_VEHICLE_VARIABLE) */
+    template <typename T>
+    static T readResult(TraCIBuffer& buf, uint8_t commandId, uint8_t variableId, const std::string& objectId, uint8_t resultTypeId)
+    {
+        readStatus(buf, commandId);
+        readResponseHeader(buf, static_cast<uint8_t>(commandId + 0x10), variableId, objectId, resultTypeId);
+        T res;
+        buf >> res;
+        return res;
+    }
+
+protected:
+    static void readResponseHeader(TraCIBuffer& buf, uint8_t responseId, uint8_t variableId, const std::string& objectId, uint8_t resultTypeId);
+
+protected:
+    TraCIConnection* connection;
+    std::string message; /**< all queued commands, ready to send */
+    size_t commandCount = 0;
+};
+
+} // namespace veins
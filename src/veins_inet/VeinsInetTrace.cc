@@ -0,0 +1,215 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins_inet/VeinsInetTrace.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using veins::VeinsInetTraceHeader;
+using veins::VeinsInetTraceReader;
+using veins::VeinsInetTraceRecord;
+using veins::VeinsInetTraceWriter;
+
+namespace {
+const char TRACE_MAGIC[8] = "VITRACE";
+const uint32_t TRACE_VERSION = 1;
+const uint32_t NO_STRING = UINT32_MAX;
+} // namespace
+
+VeinsInetTraceWriter::VeinsInetTraceWriter(const std::string& fileName, simtime_t updateInterval)
+    : fileName(fileName)
+{
+    file = fopen(fileName.c_str(), "wb");
+    if (!file) throw cRuntimeError("Cannot open trace file \"%s\" for writing", fileName.c_str());
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.recordSize = sizeof(VeinsInetTraceRecord);
+    header.simtimeScaleExp = SimTime::getScaleExp();
+    header.updateInterval = updateInterval.raw();
+
+    // placeholder, rewritten by close()
+    write(&header, sizeof(header));
+}
+
+VeinsInetTraceWriter::~VeinsInetTraceWriter()
+{
+    // an unclosed trace keeps stringTableOffset == 0 and will be rejected by VeinsInetTraceReader
+    if (file) fclose(file);
+}
+
+void VeinsInetTraceWriter::addCreate(const std::string& nodeId, const std::string& moduleType, const std::string& moduleName, const std::string& displayString, const inet::Coord& position, const std::string& roadId, double speed, double angle)
+{
+    VeinsInetTraceRecord record;
+    record.kind = VeinsInetTraceRecord::CREATE;
+    record.nodeId = intern(nodeId);
+    record.roadId = intern(roadId);
+    record.moduleType = intern(moduleType);
+    record.moduleName = intern(moduleName);
+    record.displayString = intern(displayString);
+    record.x = position.x;
+    record.y = position.y;
+    record.z = position.z;
+    record.speed = speed;
+    record.angle = angle;
+    writeRecord(record);
+}
+
+void VeinsInetTraceWriter::addUpdate(const std::string& nodeId, const inet::Coord& position, const std::string& roadId, double speed, double angle)
+{
+    VeinsInetTraceRecord record;
+    record.kind = VeinsInetTraceRecord::UPDATE;
+    record.nodeId = intern(nodeId);
+    record.roadId = intern(roadId);
+    record.moduleType = NO_STRING;
+    record.moduleName = NO_STRING;
+    record.displayString = NO_STRING;
+    record.x = position.x;
+    record.y = position.y;
+    record.z = position.z;
+    record.speed = speed;
+    record.angle = angle;
+    writeRecord(record);
+}
+
+void VeinsInetTraceWriter::addRemove(const std::string& nodeId)
+{
+    VeinsInetTraceRecord record;
+    memset(&record, 0, sizeof(record));
+    record.kind = VeinsInetTraceRecord::REMOVE;
+    record.nodeId = intern(nodeId);
+    record.roadId = NO_STRING;
+    record.moduleType = NO_STRING;
+    record.moduleName = NO_STRING;
+    record.displayString = NO_STRING;
+    writeRecord(record);
+}
+
+void VeinsInetTraceWriter::close()
+{
+    ASSERT(file);
+
+    header.stringTableOffset = sizeof(VeinsInetTraceHeader) + header.recordCount * sizeof(VeinsInetTraceRecord);
+    header.stringCount = strings.size();
+    for (auto s : strings) {
+        uint32_t length = s->size();
+        write(&length, sizeof(length));
+        write(s->c_str(), length + 1);
+    }
+
+    if (fseek(file, 0, SEEK_SET) != 0) throw cRuntimeError("Cannot seek in trace file \"%s\"", fileName.c_str());
+    write(&header, sizeof(header));
+
+    if (fclose(file) != 0) throw cRuntimeError("Cannot close trace file \"%s\"", fileName.c_str());
+    file = nullptr;
+}
+
+uint32_t VeinsInetTraceWriter::intern(const std::string& s)
+{
+    auto i = stringIndices.find(s);
+    if (i != stringIndices.end()) return i->second;
+
+    uint32_t index = strings.size();
+    auto inserted = stringIndices.emplace(s, index).first;
+    strings.push_back(&inserted->first);
+    return index;
+}
+
+void VeinsInetTraceWriter::write(const void* data, size_t size)
+{
+    if (fwrite(data, 1, size, file) != size) throw cRuntimeError("Cannot write to trace file \"%s\"", fileName.c_str());
+}
+
+void VeinsInetTraceWriter::writeRecord(VeinsInetTraceRecord& record)
+{
+    if (!file) throw cRuntimeError("Trace file \"%s\" already closed", fileName.c_str());
+
+    record.time = simTime().raw();
+    write(&record, sizeof(record));
+    header.recordCount++;
+}
+
+VeinsInetTraceReader::VeinsInetTraceReader(const std::string& fileName)
+    : fileName(fileName)
+{
+#ifndef _WIN32
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) throw cRuntimeError("Cannot open trace file \"%s\"", fileName.c_str());
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw cRuntimeError("Cannot stat trace file \"%s\"", fileName.c_str());
+    }
+    dataSize = st.st_size;
+    void* mapping = (dataSize > 0) ? mmap(nullptr, dataSize, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapping == MAP_FAILED) throw cRuntimeError("Cannot map trace file \"%s\"", fileName.c_str());
+    data = static_cast<const char*>(mapping);
+#else
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file) throw cRuntimeError("Cannot open trace file \"%s\"", fileName.c_str());
+    char chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) buffer.insert(buffer.end(), chunk, chunk + n);
+    fclose(file);
+    data = buffer.data();
+    dataSize = buffer.size();
+#endif
+
+    if (dataSize < sizeof(VeinsInetTraceHeader)) throw cRuntimeError("Trace file \"%s\" is truncated", fileName.c_str());
+    header = reinterpret_cast<const VeinsInetTraceHeader*>(data);
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0) throw cRuntimeError("\"%s\" is not a trace file", fileName.c_str());
+    if (header->version != TRACE_VERSION || header->recordSize != sizeof(VeinsInetTraceRecord)) throw cRuntimeError("Trace file \"%s\" has unsupported format version %u", fileName.c_str(), header->version);
+    if (header->simtimeScaleExp != SimTime::getScaleExp()) throw cRuntimeError("Trace file \"%s\" was recorded with simtime-resolution 1e%d, but this simulation uses 1e%d", fileName.c_str(), header->simtimeScaleExp, SimTime::getScaleExp());
+    if (header->stringTableOffset == 0) throw cRuntimeError("Trace file \"%s\" is incomplete (recording simulation did not finish)", fileName.c_str());
+    if (header->stringTableOffset != sizeof(VeinsInetTraceHeader) + header->recordCount * sizeof(VeinsInetTraceRecord) || header->stringTableOffset > dataSize) throw cRuntimeError("Trace file \"%s\" is corrupt", fileName.c_str());
+
+    records = reinterpret_cast<const VeinsInetTraceRecord*>(data + sizeof(VeinsInetTraceHeader));
+
+    // index the string table, strings themselves stay in the mapping
+    strings.reserve(header->stringCount);
+    size_t offset = header->stringTableOffset;
+    for (uint64_t i = 0; i < header->stringCount; i++) {
+        uint32_t length;
+        if (offset + sizeof(length) > dataSize) throw cRuntimeError("Trace file \"%s\" is corrupt", fileName.c_str());
+        memcpy(&length, data + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length + 1 > dataSize || data[offset + length] != '\0') throw cRuntimeError("Trace file \"%s\" is corrupt", fileName.c_str());
+        strings.push_back(data + offset);
+        offset += length + 1;
+    }
+}
+
+VeinsInetTraceReader::~VeinsInetTraceReader()
+{
+#ifndef _WIN32
+    if (data) munmap(const_cast<char*>(data), dataSize);
+#endif
+}
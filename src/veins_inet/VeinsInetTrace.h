@@ -0,0 +1,169 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "inet/common/geometry/common/Coord.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * On-disk layout of a mobility trace, as written by VeinsInetTraceWriter and read by VeinsInetTraceReader.
+ *
+ * A trace file is a VeinsInetTraceHeader, followed by header.recordCount fixed-size VeinsInetTraceRecord entries (in order of simulation time),
+ * followed by a string table of header.stringCount entries (each a uint32_t length, the characters, and a terminating '\0').
+ * All values are stored in host byte order, simulation times as raw SimTime values.
+ *
+ */
+struct VeinsInetTraceHeader {
+    char magic[8]; /**< "VITRACE" */
+    uint32_t version; /**< format version */
+    uint32_t recordSize; /**< sizeof(VeinsInetTraceRecord) */
+    int32_t simtimeScaleExp; /**< SimTime scale exponent of the recording, raw times are meaningless without it */
+    uint32_t reserved;
+    int64_t updateInterval; /**< TraCI update interval of the recording (raw SimTime) */
+    uint64_t recordCount; /**< number of records */
+    uint64_t stringTableOffset; /**< file offset of the string table, 0 if the trace was not closed properly */
+    uint64_t stringCount; /**< number of entries in the string table */
+};
+
+/**
+ * @brief
+ * One create, update, or remove event of a vehicle. Strings are stored as indices into the string table.
+ */
+struct VeinsInetTraceRecord {
+    enum Kind : uint32_t {
+        CREATE = 1, /**< vehicle was added; arguments of preInitializeModule() */
+        UPDATE = 2, /**< vehicle moved; arguments of updateModulePosition() */
+        REMOVE = 3, /**< vehicle was removed */
+    };
+
+    int64_t time; /**< raw SimTime of the event */
+    uint32_t kind; /**< one of Kind */
+    uint32_t nodeId; /**< string index of TraCI vehicle id */
+    uint32_t roadId; /**< string index of road id (CREATE, UPDATE) */
+    uint32_t moduleType; /**< string index of NED type of the host module (CREATE) */
+    uint32_t moduleName; /**< string index of name of the host module vector (CREATE) */
+    uint32_t displayString; /**< string index of display string of the host module (CREATE) */
+    double x; /**< OMNeT++ position of front bumper */
+    double y;
+    double z;
+    double speed; /**< speed in m/s */
+    double angle; /**< heading in rad */
+};
+
+static_assert(sizeof(VeinsInetTraceHeader) == 56, "unexpected padding in VeinsInetTraceHeader");
+static_assert(sizeof(VeinsInetTraceRecord) == 72, "unexpected padding in VeinsInetTraceRecord");
+
+/**
+ * @brief
+ * Writes vehicle events to a trace file as they happen.
+ *
+ * Records are streamed to disk; strings are interned and only written (together with the final header) by close().
+ *
+ */
+class VEINS_INET_API VeinsInetTraceWriter {
+public:
+    VeinsInetTraceWriter(const std::string& fileName, simtime_t updateInterval);
+    ~VeinsInetTraceWriter();
+
+    void addCreate(const std::string& nodeId, const std::string& moduleType, const std::string& moduleName, const std::string& displayString, const inet::Coord& position, const std::string& roadId, double speed, double angle);
+    void addUpdate(const std::string& nodeId, const inet::Coord& position, const std::string& roadId, double speed, double angle);
+    void addRemove(const std::string& nodeId);
+
+    /** @brief writes the string table and the final header, further events are an error */
+    void close();
+
+    uint64_t getRecordCount() const
+    {
+        return header.recordCount;
+    }
+
+protected:
+    uint32_t intern(const std::string& s);
+    void write(const void* data, size_t size);
+    void writeRecord(VeinsInetTraceRecord& record);
+
+protected:
+    std::string fileName;
+    FILE* file = nullptr;
+    VeinsInetTraceHeader header;
+    std::unordered_map<std::string, uint32_t> stringIndices; /**< index of every string written so far */
+    std::vector<const std::string*> strings; /**< strings in order of their index, pointing into stringIndices */
+};
+
+/**
+ * @brief
+ * Maps a trace file into memory and gives access to its records and strings without copying them.
+ */
+class VEINS_INET_API VeinsInetTraceReader {
+public:
+    explicit VeinsInetTraceReader(const std::string& fileName);
+    ~VeinsInetTraceReader();
+
+    size_t size() const
+    {
+        return header->recordCount;
+    }
+
+    const VeinsInetTraceRecord& getRecord(size_t i) const
+    {
+        return records[i];
+    }
+
+    const char* getString(uint32_t index) const
+    {
+        if (index >= strings.size()) throw cRuntimeError("Trace file \"%s\" refers to nonexistent string %u", fileName.c_str(), index);
+        return strings[index];
+    }
+
+    simtime_t getTime(const VeinsInetTraceRecord& record) const
+    {
+        return SimTime::fromRaw(record.time);
+    }
+
+    simtime_t getUpdateInterval() const
+    {
+        return SimTime::fromRaw(header->updateInterval);
+    }
+
+protected:
+    std::string fileName;
+    const char* data = nullptr; /**< start of file contents */
+    size_t dataSize = 0;
+#ifdef _WIN32
+    std::vector<char> buffer; /**< file contents, for platforms without mmap */
+#endif
+    const VeinsInetTraceHeader* header = nullptr;
+    const VeinsInetTraceRecord* records = nullptr;
+    std::vector<const char*> strings; /**< string table entries, pointing into data */
+};
+
+} // namespace veins
@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins_inet/VeinsInetTraceReplayManager.h"
+
+#include "veins/base/utils/Coord.h"
+
+using veins::VeinsInetTraceReader;
+using veins::VeinsInetTraceRecord;
+using veins::VeinsInetTraceReplayManager;
+
+Define_Module(veins::VeinsInetTraceReplayManager);
+
+VeinsInetTraceReplayManager::~VeinsInetTraceReplayManager()
+{
+    cancelAndDelete(replayTrigger);
+}
+
+void VeinsInetTraceReplayManager::initialize(int stage)
+{
+    VeinsInetPassiveManagerBase::initialize(stage);
+    if (stage != 1) return;
+
+    trace.reset(new VeinsInetTraceReader(par("traceFile").stdstringValue()));
+    updateInterval = trace->getUpdateInterval();
+
+    replayTrigger = new cMessage("replay");
+    if (trace->size() > 0) scheduleAt(std::max(simTime(), trace->getTime(trace->getRecord(0))), replayTrigger);
+}
+
+void VeinsInetTraceReplayManager::finish()
+{
+    VeinsInetPassiveManagerBase::finish();
+
+    recordScalar("replayedRecords", nextRecord);
+}
+
+void VeinsInetTraceReplayManager::handleSelfMsg(cMessage* msg)
+{
+    if (msg == replayTrigger) {
+        replayStep();
+        return;
+    }
+    VeinsInetPassiveManagerBase::handleSelfMsg(msg);
+}
+
+void VeinsInetTraceReplayManager::replayStep()
+{
+    simtime_t now = simTime();
+    emit(traciTimestepBeginSignal, now);
+
+    for (; nextRecord < trace->size(); nextRecord++) {
+        const VeinsInetTraceRecord& record = trace->getRecord(nextRecord);
+        simtime_t t = trace->getTime(record);
+        if (t > now) break;
+        if (t < now) throw cRuntimeError("Trace record %zu is out of order", nextRecord);
+
+        switch (record.kind) {
+        case VeinsInetTraceRecord::CREATE: {
+            std::string nodeId = trace->getString(record.nodeId);
+            if (hosts.find(nodeId) != hosts.end()) throw cRuntimeError("Trace record %zu adds duplicate vehicle \"%s\"", nextRecord, nodeId.c_str());
+            addHostModule(nodeId, trace->getString(record.moduleType), trace->getString(record.moduleName), trace->getString(record.displayString), Coord(record.x, record.y, record.z), trace->getString(record.roadId), record.speed, Heading(record.angle));
+            break;
+        }
+        case VeinsInetTraceRecord::UPDATE: {
+            std::string nodeId = trace->getString(record.nodeId);
+            if (hosts.find(nodeId) == hosts.end()) throw cRuntimeError("Trace record %zu updates unknown vehicle \"%s\"", nextRecord, nodeId.c_str());
+            moveHostModule(nodeId, Coord(record.x, record.y, record.z), trace->getString(record.roadId), record.speed, Heading(record.angle));
+            break;
+        }
+        case VeinsInetTraceRecord::REMOVE:
+            removeHostModule(trace->getString(record.nodeId));
+            break;
+        default:
+            throw cRuntimeError("Trace record %zu has unknown kind %u", nextRecord, record.kind);
+        }
+    }
+
+    emit(traciTimestepEndSignal, now);
+
+    if (nextRecord < trace->size()) scheduleAt(trace->getTime(trace->getRecord(nextRecord)), replayTrigger);
+}
@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <memory>
+
+#include "veins_inet/veins_inet.h"
+
+#include "veins_inet/VeinsInetPassiveManagerBase.h"
+#include "veins_inet/VeinsInetTrace.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Creates and moves network nodes as recorded in a trace file, without connecting to a TraCI server.
+ *
+ * Traces are recorded by setting the traceRecordFile parameter of VeinsInetManager or VeinsInetManagerForker.
+ * Nodes are created, moved, and removed at the recorded times, with the recorded arguments to preInitializeModule() and updateModulePosition(),
+ * so mobility is identical to the recording run.
+ * There is no TraCI connection, so commands to vehicles (e.g., changing their speed) have no effect on a replay.
+ *
+ */
+class VEINS_INET_API VeinsInetTraceReplayManager : public VeinsInetPassiveManagerBase {
+public:
+    ~VeinsInetTraceReplayManager() override;
+
+    void initialize(int stage) override;
+    void finish() override;
+
+protected:
+    void handleSelfMsg(cMessage* msg) override;
+
+    /**
+     * Processes all records due at the current simulation time, then schedules the next step
+     */
+    virtual void replayStep();
+
+protected:
+    std::unique_ptr<VeinsInetTraceReader> trace;
+    size_t nextRecord = 0; /**< index of next record to replay */
+    cMessage* replayTrigger = nullptr;
+};
+
+} // namespace veins
@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetVectorRecorder.h"
+
+#include <chrono>
+#include <cmath>
+
+using veins::VeinsInetVectorRecorder;
+
+VeinsInetVectorRecorder::VeinsInetVectorRecorder(const char* name, const char* unit)
+    : unit(unit ? unit : "")
+    , vector(name)
+    , summary(name)
+{
+    if (unit) vector.setUnit(unit);
+}
+
+void VeinsInetVectorRecorder::configure(const Config& config)
+{
+    if (config.recordEvery < 1) throw cRuntimeError("Recording every %d-th sample of vector %s is not possible", config.recordEvery, vector.getName());
+
+    this->config = config;
+}
+
+void VeinsInetVectorRecorder::record(double value)
+{
+    samples++;
+
+    if (config.summaryOnly) {
+        summary.collect(value);
+        return;
+    }
+
+    if (++sinceRecorded < config.recordEvery) return;
+    if (config.changeThreshold > 0 && hasRecorded && std::fabs(value - lastRecorded) <= config.changeThreshold) return;
+
+    sinceRecorded = 0;
+    hasRecorded = true;
+    lastRecorded = value;
+    recorded++;
+
+    auto start = std::chrono::steady_clock::now();
+    vector.record(value);
+    overhead += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void VeinsInetVectorRecorder::finish()
+{
+    if (config.summaryOnly && summary.getCount() > 0) {
+        auto start = std::chrono::steady_clock::now();
+        summary.recordAs(vector.getName(), unit.empty() ? nullptr : unit.c_str());
+        overhead += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    summary.clear();
+    sinceRecorded = 0;
+    hasRecorded = false;
+}
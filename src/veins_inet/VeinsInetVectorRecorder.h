@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <string>
+
+#include "veins_inet/veins_inet.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Records a vector of per-vehicle samples (e.g., speed) with less overhead than a plain cOutVector.
+ *
+ * Samples can be decimated (only every Nth sample, or only samples that differ enough from the last recorded one),
+ * or not recorded as a vector at all, keeping only count, mean, min, and max (recorded as a statistic by finish()).
+ *
+ */
+class VEINS_INET_API VeinsInetVectorRecorder {
+public:
+    struct Config {
+        int recordEvery = 1; /**< record only every Nth sample */
+        double changeThreshold = 0; /**< record a sample only if it differs from the last recorded one by more than this (0 to record all) */
+        bool summaryOnly = false; /**< do not record a vector, only a summary statistic */
+    };
+
+public:
+    VeinsInetVectorRecorder(const char* name, const char* unit = nullptr);
+
+    void configure(const Config& config);
+
+    /**
+     * Records a sample at the current simulation time (unless it is decimated)
+     */
+    void record(double value);
+
+    /**
+     * In summary mode, records the summary statistic (in the context of the calling module), then starts a new summary
+     */
+    void finish();
+
+    /** @brief number of samples offered to record() */
+    uint64_t getSampleCount() const
+    {
+        return samples;
+    }
+
+    /** @brief number of samples recorded to the vector */
+    uint64_t getRecordedCount() const
+    {
+        return recorded;
+    }
+
+    /**
+     * @brief wall clock time (s) spent in the output vector manager recording samples and summaries
+     *
+     * Includes the writes (e.g., SQLite transactions) the output vector manager makes when its own buffers fill,
+     * but not the final one at the end of the run.
+     */
+    double getOverhead() const
+    {
+        return overhead;
+    }
+
+protected:
+    Config config;
+    std::string unit;
+    cOutVector vector;
+    cStdDev summary;
+    int sinceRecorded = 0; /**< samples skipped since the last recorded one */
+    bool hasRecorded = false;
+    double lastRecorded = 0; /**< value of the last recorded sample */
+    uint64_t samples = 0;
+    uint64_t recorded = 0;
+    double overhead = 0;
+};
+
+} // namespace veins
@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins_inet/VeinsInetVehicleStore.h"
+
+#include <cmath>
+
+using veins::VeinsInetVehicleStore;
+
+size_t VeinsInetVehicleStore::allocate(const inet::Coord& position, double v, double heading, simtime_t t)
+{
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = x.size();
+        for (auto array : {&x, &y, &z, &speed, &angle, &vx, &vy, &qw, &qz, &acceleration, &lastSpeed, &lastTime, &lastX, &lastY, &distance, &co2, &haltingTime}) {
+            array->push_back(0);
+        }
+        updated.push_back(0);
+    }
+
+    update(slot, position, v, heading);
+    lastSpeed[slot] = -1;
+    lastTime[slot] = t.dbl();
+    lastX[slot] = position.x;
+    lastY[slot] = position.y;
+    acceleration[slot] = 0;
+    distance[slot] = 0;
+    co2[slot] = 0;
+    haltingTime[slot] = 0;
+    return slot;
+}
+
+void VeinsInetVehicleStore::release(size_t slot)
+{
+    updated[slot] = 0;
+    freeSlots.push_back(slot);
+}
+
+void VeinsInetVehicleStore::computeKinematics(simtime_t t)
+{
+    const size_t n = x.size();
+    const double now = t.dbl();
+
+    // no branches or calls other than math functions, so this can be vectorized
+    // (slots not updated are computed as well and their results discarded below)
+    for (size_t i = 0; i < n; i++) {
+        vx[i] = std::cos(angle[i]) * speed[i];
+        vy[i] = -std::sin(angle[i]) * speed[i];
+        // rotation about the z axis by -angle (OMNeT++ y axis points down)
+        qw[i] = std::cos(0.5 * angle[i]);
+        qz[i] = -std::sin(0.5 * angle[i]);
+    }
+
+    // same for accumulators: slots not updated are masked out instead of skipped
+    for (size_t i = 0; i < n; i++) {
+        const bool u = updated[i];
+        const double dt = u ? now - lastTime[i] : 0;
+        const bool known = lastSpeed[i] >= 0 && speed[i] >= 0 && dt > 0;
+        const double a = known ? (speed[i] - lastSpeed[i]) / (dt > 0 ? dt : 1) : 0;
+        const double v = speed[i] >= 0 ? speed[i] : 0;
+        const double dx = x[i] - lastX[i];
+        const double dy = y[i] - lastY[i];
+
+        acceleration[i] = u ? a : acceleration[i];
+        distance[i] += u ? std::sqrt(dx * dx + dy * dy) : 0;
+        co2[i] += co2Emission(v, a) * dt;
+        haltingTime[i] += (speed[i] >= 0 && speed[i] < haltingSpeed) ? dt : 0;
+
+        lastSpeed[i] = u ? speed[i] : lastSpeed[i];
+        lastTime[i] = u ? now : lastTime[i];
+        lastX[i] = u ? x[i] : lastX[i];
+        lastY[i] = u ? y[i] : lastY[i];
+        updated[i] = 0;
+    }
+}
@@ -0,0 +1,173 @@
+//
+// Copyright (C) 2006-2017 Christoph Sommer <sommer@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "veins_inet/veins_inet.h"
+
+#include "inet/common/geometry/common/Coord.h"
+#include "inet/common/geometry/common/Quaternion.h"
+
+namespace veins {
+
+/**
+ * @brief
+ * Kinematic state of all vehicles of a manager, stored as one contiguous array per quantity (structure of arrays).
+ *
+ * The manager writes the position, speed, and heading reported for every vehicle into its slot,
+ * then derives velocity vectors, orientations, and accelerations, and accumulates travelled distance, CO2 emission, and halting time
+ * of all slots in loops per time step (computeKinematics()) which the compiler can vectorize.
+ * VeinsInetMobility modules read the values of their vehicle's slot.
+ *
+ */
+class VEINS_INET_API VeinsInetVehicleStore {
+public:
+    /**
+     * Returns a free slot, initialized to the given state (which has no previous speed to derive an acceleration from)
+     */
+    size_t allocate(const inet::Coord& position, double v, double heading, simtime_t t);
+
+    /**
+     * Returns a slot to the pool of free slots
+     */
+    void release(size_t slot);
+
+    /**
+     * Sets the state of a vehicle as reported in the current time step
+     */
+    void update(size_t slot, const inet::Coord& position, double v, double heading)
+    {
+        x[slot] = position.x;
+        y[slot] = position.y;
+        z[slot] = position.z;
+        speed[slot] = v;
+        angle[slot] = heading;
+        updated[slot] = 1;
+    }
+
+    /**
+     * Derives velocity, orientation, and acceleration of all slots updated since the last call, and updates their accumulators
+     */
+    void computeKinematics(simtime_t t);
+
+    inet::Coord getPosition(size_t slot) const
+    {
+        return inet::Coord(x[slot], y[slot], z[slot]);
+    }
+    inet::Coord getVelocity(size_t slot) const
+    {
+        return inet::Coord(vx[slot], vy[slot], 0);
+    }
+    /** @brief heading as a rotation about the z axis (0 is east, counter-clockwise) */
+    inet::Quaternion getOrientation(size_t slot) const
+    {
+        return inet::Quaternion(qw[slot], 0, 0, qz[slot]);
+    }
+    double getSpeed(size_t slot) const
+    {
+        return speed[slot];
+    }
+    double getAngle(size_t slot) const
+    {
+        return angle[slot];
+    }
+    /** @brief acceleration (m/s^2) between the last two updates, 0 if there was only one */
+    double getAcceleration(size_t slot) const
+    {
+        return acceleration[slot];
+    }
+
+    /** @brief distance (m) travelled since the slot was allocated */
+    double getDistance(size_t slot) const
+    {
+        return distance[slot];
+    }
+    /** @brief CO2 (g) emitted since the slot was allocated, see co2Emission() */
+    double getCO2Emission(size_t slot) const
+    {
+        return co2[slot];
+    }
+    /** @brief time (s) spent slower than haltingSpeed since the slot was allocated */
+    double getHaltingTime(size_t slot) const
+    {
+        return haltingTime[slot];
+    }
+
+    /**
+     * Returns the CO2 emission rate (g/s) of an average car at speed v (m/s) and acceleration a (m/s^2).
+     * Model and parameters ("category 9 vehicle") of Cappiello et al., "A statistical model of vehicle emissions and fuel consumption", IEEE ITSC 2002, as in TraCIMobility.
+     */
+    static double co2Emission(double v, double a)
+    {
+        const double A = 1000 * 0.1326; // W/m/s
+        const double B = 1000 * 2.7384e-03; // W/(m/s)^2
+        const double C = 1000 * 1.0843e-03; // W/(m/s)^3
+        const double M = 1325.0; // kg
+        const double alpha = 1.11;
+        const double beta = 0.0134;
+        const double delta = 1.98e-06;
+        const double zeta = 0.241;
+        const double alpha1 = 0.973;
+
+        // power in W
+        double tractivePower = A * v + B * v * v + C * v * v * v + M * a * v;
+        return tractivePower <= 0 ? alpha1 : alpha + beta * v * 3.6 + delta * v * v * v * (3.6 * 3.6 * 3.6) + zeta * a * v;
+    }
+
+    static constexpr double haltingSpeed = 0.1; /**< speed (m/s) below which a vehicle counts as halting, as in SUMO */
+
+    /** @brief number of slots in use */
+    size_t size() const
+    {
+        return x.size() - freeSlots.size();
+    }
+
+protected:
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> speed; /**< m/s, -1 if unknown */
+    std::vector<double> angle; /**< rad */
+    std::vector<uint8_t> updated; /**< whether the slot was updated since the last computeKinematics() */
+
+    std::vector<double> vx; /**< derived: velocity along x (m/s) */
+    std::vector<double> vy; /**< derived: velocity along y (m/s) */
+    std::vector<double> qw; /**< derived: real part of orientation quaternion */
+    std::vector<double> qz; /**< derived: z component of orientation quaternion */
+    std::vector<double> acceleration; /**< derived: m/s^2 */
+    std::vector<double> lastSpeed; /**< speed at last computeKinematics() the slot was updated, -1 if unknown */
+    std::vector<double> lastTime; /**< time (s) of last computeKinematics() the slot was updated */
+    std::vector<double> lastX; /**< x at last computeKinematics() the slot was updated */
+    std::vector<double> lastY; /**< y at last computeKinematics() the slot was updated */
+
+    std::vector<double> distance; /**< accumulated: m */
+    std::vector<double> co2; /**< accumulated: g */
+    std::vector<double> haltingTime; /**< accumulated: s */
+
+    std::vector<size_t> freeSlots;
+};
+
+} // namespace veins